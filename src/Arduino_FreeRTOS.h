@@ -1275,6 +1275,70 @@
     #define traceRETURN_xQueueReceive( xReturn )
 #endif
 
+#ifndef traceENTER_pvQueueAcquireSend
+    #define traceENTER_pvQueueAcquireSend( xQueue, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_pvQueueAcquireSend
+    #define traceRETURN_pvQueueAcquireSend( pvItem )
+#endif
+
+#ifndef traceENTER_vQueueCommitSend
+    #define traceENTER_vQueueCommitSend( xQueue )
+#endif
+
+#ifndef traceRETURN_vQueueCommitSend
+    #define traceRETURN_vQueueCommitSend()
+#endif
+
+#ifndef traceENTER_pvQueueAcquireReceive
+    #define traceENTER_pvQueueAcquireReceive( xQueue, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_pvQueueAcquireReceive
+    #define traceRETURN_pvQueueAcquireReceive( pcItem )
+#endif
+
+#ifndef traceENTER_vQueueReleaseReceive
+    #define traceENTER_vQueueReleaseReceive( xQueue )
+#endif
+
+#ifndef traceRETURN_vQueueReleaseReceive
+    #define traceRETURN_vQueueReleaseReceive()
+#endif
+
+#ifndef traceENTER_uxQueueSendMultiple
+    #define traceENTER_uxQueueSendMultiple( xQueue, pvItems, uxItems, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_uxQueueSendMultiple
+    #define traceRETURN_uxQueueSendMultiple( uxSent )
+#endif
+
+#ifndef traceENTER_uxQueueReceiveMultiple
+    #define traceENTER_uxQueueReceiveMultiple( xQueue, pvItems, uxItems, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_uxQueueReceiveMultiple
+    #define traceRETURN_uxQueueReceiveMultiple( uxReceived )
+#endif
+
+#ifndef traceENTER_uxQueueSendMultipleFromISR
+    #define traceENTER_uxQueueSendMultipleFromISR( xQueue, pvItems, uxItems, pxHigherPriorityTaskWoken )
+#endif
+
+#ifndef traceRETURN_uxQueueSendMultipleFromISR
+    #define traceRETURN_uxQueueSendMultipleFromISR( uxSent )
+#endif
+
+#ifndef traceENTER_uxQueueReceiveMultipleFromISR
+    #define traceENTER_uxQueueReceiveMultipleFromISR( xQueue, pvItems, uxItems, pxHigherPriorityTaskWoken )
+#endif
+
+#ifndef traceRETURN_uxQueueReceiveMultipleFromISR
+    #define traceRETURN_uxQueueReceiveMultipleFromISR( uxReceived )
+#endif
+
 #ifndef traceENTER_xQueueSemaphoreTake
     #define traceENTER_xQueueSemaphoreTake( xQueue, xTicksToWait )
 #endif
@@ -2487,6 +2551,38 @@
     #define traceRETURN_xStreamBufferReceive( xReceivedLength )
 #endif
 
+#ifndef traceENTER_xStreamBufferAcquireSend
+    #define traceENTER_xStreamBufferAcquireSend( xStreamBuffer, ppvData, xDataLengthBytes, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_xStreamBufferAcquireSend
+    #define traceRETURN_xStreamBufferAcquireSend( xReturn )
+#endif
+
+#ifndef traceENTER_vStreamBufferCommitSend
+    #define traceENTER_vStreamBufferCommitSend( xStreamBuffer, xDataLengthBytes )
+#endif
+
+#ifndef traceRETURN_vStreamBufferCommitSend
+    #define traceRETURN_vStreamBufferCommitSend()
+#endif
+
+#ifndef traceENTER_xStreamBufferAcquireReceive
+    #define traceENTER_xStreamBufferAcquireReceive( xStreamBuffer, ppvData, xTicksToWait )
+#endif
+
+#ifndef traceRETURN_xStreamBufferAcquireReceive
+    #define traceRETURN_xStreamBufferAcquireReceive( xReturn )
+#endif
+
+#ifndef traceENTER_vStreamBufferReleaseReceive
+    #define traceENTER_vStreamBufferReleaseReceive( xStreamBuffer, xDataLengthBytes )
+#endif
+
+#ifndef traceRETURN_vStreamBufferReleaseReceive
+    #define traceRETURN_vStreamBufferReleaseReceive()
+#endif
+
 #ifndef traceENTER_xStreamBufferNextMessageLengthBytes
     #define traceENTER_xStreamBufferNextMessageLengthBytes( xStreamBuffer )
 #endif
@@ -48,21 +48,51 @@
  * The default is to change nothing. */
 #define configUSE_PORT_DELAY                1
 
+/* vTaskDelayUs() and vTaskDelayUntilUs() block with compare match B of the tick Timer (portUSE_TIMER1 to portUSE_TIMER5).
+ * delay() then blocks for the whole delay, rather than busy waiting for the part of a Tick. */
+#define configUSE_PORT_DELAY_US             0
+
 /* And on to the things the same no matter the AVR type... */
 #define configUSE_PREEMPTION                1
 
+/* Critical sections mask only the kernel aware interrupts listed by portKERNEL_INTERRUPTS in FreeRTOSVariant.h,
+ * rather than all interrupts. Interrupts left enabled must not use the FreeRTOS API. */
+#define configUSE_KERNEL_INTERRUPT_MASK     0
+
 #define configCPU_CLOCK_HZ                  ( ( uint32_t ) F_CPU )          // This F_CPU variable set by the environment
 #define configTICK_TYPE_WIDTH_IN_BITS       TICK_TYPE_WIDTH_16_BITS
 
 #define configMAX_PRIORITIES                4
+
+/* The highest ready priority is found from a bit map of the ready priorities, rather than by walking the ready lists.
+ * Requires configMAX_PRIORITIES of 8 or less. */
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION 1
+
 #define configMAX_TASK_NAME_LEN             16
 
+/* Task names are pointers to strings in flash, created with PSTR( "name" ), rather than copied into each TCB.
+ * pcTaskGetName(), the timer names and the uxTaskGetSystemState() names are then flash pointers, for the _P functions. */
+#define configTASK_NAMES_IN_PROGMEM         0
+
+
 /* Set the stack depth type to be uint16_t, otherwise it defaults to StackType_t */
 #define configSTACK_DEPTH_TYPE              uint16_t
 
 #define configMINIMAL_STACK_SIZE            192
+
+/* The Tick, context switches and portISR_STACK() interrupts run on an interrupt stack of this many bytes,
+ * taken from the RAM below RAMEND that main() used before the scheduler started. 0 runs them on the task stack. */
+#define configISR_STACK_SIZE                0
+
+/* Set to 1 to add the RAM that main() and setup() used as a stack to the heap, once the scheduler has started.
+ * This changes the heap layout, so it is off unless chosen. */
+#define configRECLAIM_MAIN_STACK            0
+
+/* 1 checks the saved stack pointer at each context switch, 2 also checks the last 16 stack bytes,
+ * and 3 checks the saved stack pointer and the last stack byte only, cheap enough to leave on. */
 #define configCHECK_FOR_STACK_OVERFLOW      1
 #define configUSE_TRACE_FACILITY            0
+#define configGENERATE_RUN_TIME_STATS       0   // Run time counter from the Arduino Timer0, 4us at 16MHz
 
 #define configUSE_MUTEXES                   1
 #define configUSE_RECURSIVE_MUTEXES         1
@@ -74,18 +104,39 @@
 #define configUSE_MALLOC_FAILED_HOOK        1
 #define configQUEUE_REGISTRY_SIZE           0
 #define configSUPPORT_DYNAMIC_ALLOCATION    1
+
+/* The heap is malloc() by default (heap_3.c). Set configUSE_HEAP_AVR to 1 for heap_avr.c, a bounded time allocator
+ * using its own configTOTAL_HEAP_SIZE array, leaving the malloc() heap for the Arduino libraries. */
+#define configUSE_HEAP_AVR                  0
+#define configTOTAL_HEAP_SIZE               ( ( size_t ) 1024 )
+
+/* With heap_avr.c, set to 1 to allocate task stacks with pvPortMallocStack(), from the external SRAM with portUSE_XMEM. */
+#define configSTACK_ALLOCATION_FROM_SEPARATE_HEAP   0
+
+/* Keep the TCB and stack of up to this many deleted tasks, to be reused by xTaskCreate() for a task of the same stack depth. */
+#define configTASK_RECYCLE_POOL_SIZE        0
+
 #define configSUPPORT_STATIC_ALLOCATION     0
 
 #define configUSE_IDLE_HOOK                 1
 #define configIDLE_SHOULD_YIELD             1
 #define configUSE_TICK_HOOK                 0
 
+/* Tickless idle stretches the Tick and sleeps when all tasks are blocked for at least two Ticks.
+ * The sleep mode can be chosen with portTICKLESS_SLEEP_MODE, see FreeRTOSVariant.h. */
+#define configUSE_TICKLESS_IDLE             0
+
 /* Timer definitions. */
 #define configUSE_TIMERS                    1
 #define configTIMER_TASK_PRIORITY           ( configMAX_PRIORITIES-1 )
 #define configTIMER_TASK_STACK_DEPTH        92
 #define configTIMER_QUEUE_LENGTH            10
 
+/* Basic tasks (basic_tasks.h) run to completion, one after another, on the stack of one runner task. */
+#define configUSE_BASIC_TASKS               0
+#define configBASIC_TASK_PRIORITY           ( 1 )
+#define configBASIC_TASK_STACK_DEPTH        configMINIMAL_STACK_SIZE
+
 /* Set the following definitions to 1 to include the API function, or zero
 to exclude the API function. */
 
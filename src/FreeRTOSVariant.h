@@ -40,13 +40,34 @@ extern "C" {
 
 // System Tick - Scheduler timer
 // Use the Watchdog timer, and choose the rate at which scheduler interrupts will occur.
+// Or use one of the hardware Timers, and choose the rate with configTICK_RATE_HZ.
 
 /* Watchdog Timer is 128kHz nominal, but 120 kHz at 5V DC and 25 degrees is actually more accurate, from data sheet. */
 
-#ifndef portUSE_WDTO
+#if !defined( portUSE_WDTO ) && !defined( portUSE_TIMER0 ) && !defined( portUSE_TIMER0_MILLIS ) && !defined( portUSE_TIMER1 ) && \
+    !defined( portUSE_TIMER2 ) && !defined( portUSE_TIMER2_ASYNC ) && !defined( portUSE_TIMER3 ) && !defined( portUSE_TIMER4 ) && \
+    !defined( portUSE_TIMER5 )
     #define portUSE_WDTO        WDTO_15MS    // portUSE_WDTO to use the Watchdog Timer for xTaskIncrementTick
 #endif
 
+/* Hardware Timer options:      portUSE_TIMER0_MILLIS   shares Arduino Timer0, keeping millis(), 1.024ms Tick at 16MHz
+                                portUSE_TIMER1          16-bit, all devices (used by Servo library, PWM on Uno pins 9 & 10)
+                                portUSE_TIMER2          8-bit, not ATmega32U4 (used by tone(), PWM on Uno pins 3 & 11)
+                                portUSE_TIMER2_ASYNC    8-bit, clocked from a 32.768kHz crystal on TOSC1 & TOSC2, ATmega1284p
+                                portUSE_TIMER3          16-bit, ATmega1284p, ATmega32U4, ATmega2560
+                                portUSE_TIMER4          16-bit, ATmega2560
+                                portUSE_TIMER5          16-bit, ATmega2560
+
+   For Timer1 to Timer5, the prescaler and compare value are calculated from F_CPU and configTICK_RATE_HZ,
+   and compilation will fail if the rate can't be generated exactly.
+   For portUSE_TIMER2_ASYNC they are calculated from 32768Hz, so configTICK_RATE_HZ must be a power of 2.
+*/
+
+/* Tickless idle sleep mode:    portTICKLESS_SLEEP_MODE defaults to SLEEP_MODE_PWR_DOWN for the WDT,
+                                SLEEP_MODE_PWR_SAVE for portUSE_TIMER2_ASYNC, and SLEEP_MODE_IDLE for other Timers.
+                                millis() and micros() stop during SLEEP_MODE_PWR_DOWN and SLEEP_MODE_PWR_SAVE.
+*/
+
 /* Watchdog period options:     WDTO_15MS
                                 WDTO_30MS
                                 WDTO_60MS
@@ -61,12 +82,89 @@ extern "C" {
 
     #define configTICK_RATE_HZ  ( (TickType_t)( (uint32_t)128000 >> (portUSE_WDTO + 11) ) )  // 2^11 = 2048 WDT scaler for 128kHz Timer
     #define portTICK_PERIOD_MS  ( (TickType_t) _BV( portUSE_WDTO + 4 ) )
+
+    #ifndef portCALIBRATE_WDTO
+        #define portCALIBRATE_WDTO          0   // If 1, measure the WDT period against the crystal clock (Timer0) when the scheduler starts.
+                                                // millis() then loses up to two WDT periods, as interrupts are disabled.
+    #endif
+
+    #ifndef portRECALIBRATE_WDTO_TICKS
+        #define portRECALIBRATE_WDTO_TICKS  0   // If not 0, remeasure the WDT period against micros() every n Ticks (max 65535)
+    #endif
+
+#elif defined( portUSE_TIMER0_MILLIS )
+
+    /* The Arduino core runs Timer0 with a prescaler of 64, overflowing every 256 counts. */
+    #if ( F_CPU > 16384000UL )
+        #error "portUSE_TIMER0_MILLIS Tick would be shorter than 1ms at this F_CPU. Use a hardware Timer instead."
+    #endif
+
+    #define configTICK_RATE_HZ  ( (TickType_t)( (uint32_t)F_CPU >> 14 ) )   // 2^14 = 64 prescaler x 256 counts
+    #define portTICK_PERIOD_MS  ( (TickType_t) ( 1000 / configTICK_RATE_HZ ) )
+
+#elif defined( portUSE_TIMER1 ) || defined( portUSE_TIMER2 ) || defined( portUSE_TIMER2_ASYNC ) || defined( portUSE_TIMER3 ) || \
+      defined( portUSE_TIMER4 ) || defined( portUSE_TIMER5 )
+
+    #ifndef configTICK_RATE_HZ
+        #if defined( portUSE_TIMER2_ASYNC )
+            #define configTICK_RATE_HZ  128     // Must be a power of 2 integer constant, from the 32768Hz crystal
+        #else
+            #define configTICK_RATE_HZ  1000    // Must be an integer constant, as it is tested by the preprocessor
+        #endif
+    #endif
+
+    /* portTICK_PERIOD_MS is a whole number of milliseconds, so it is left undefined for a Tick shorter than 1ms.
+       Use pdMS_TO_TICKS() to convert milliseconds at any rate. */
+    #if ( configTICK_RATE_HZ <= 1000 )
+        #define portTICK_PERIOD_MS  ( (TickType_t) ( 1000 / configTICK_RATE_HZ ) )
+    #endif
 #else
     #warning "Variant configuration must define `configTICK_RATE_HZ` and `portTICK_PERIOD_MS` as either a macro or a constant"
     #define configTICK_RATE_HZ  1
     #define portTICK_PERIOD_MS  ( (TickType_t) ( 1000 / configTICK_RATE_HZ ) )
 #endif
 
+/* Kernel aware interrupts:     With configUSE_KERNEL_INTERRUPT_MASK, critical sections only mask the interrupts listed here,
+                                as X( register, enable bits ), one entry for each register. For example:
+
+                                #define portKERNEL_INTERRUPTS( X )  X( UCSR0B, _BV( RXCIE0 ) ) X( EIMSK, _BV( INT0 ) )
+
+                                Any ISR that uses a FromISR() API must be listed. All other interrupts stay enabled during
+                                critical sections, and their ISRs must not use the FreeRTOS API. The Tick is always kernel aware.
+*/
+
+#ifndef portKERNEL_INTERRUPTS
+    #define portKERNEL_INTERRUPTS( X )
+#endif
+
+/* External memory:            portUSE_XMEM enables the external SRAM interface of the ATmega640/1280/2560, and adds
+                                the external SRAM to heap_avr.c as a second heap, from portXMEM_START for portXMEM_SIZE bytes.
+                                pvPortMalloc() prefers the internal RAM. pvPortMallocExternal(), and task stacks with
+                                configSTACK_ALLOCATION_FROM_SEPARATE_HEAP, prefer the external SRAM.
+                                Wait states and the address bus width can be set with portXMEM_XMCRA and portXMEM_XMCRB.
+*/
+
+#if defined( portUSE_XMEM )
+    #if !defined( XMCRA )
+        #error portUSE_XMEM needs the external memory interface of the ATmega640/1280/2560.
+    #endif
+    #if ( configUSE_HEAP_AVR != 1 )
+        #error portUSE_XMEM needs configUSE_HEAP_AVR.
+    #endif
+    #ifndef portXMEM_START
+        #define portXMEM_START      ( RAMEND + 1 )
+    #endif
+    #ifndef portXMEM_SIZE
+        #define portXMEM_SIZE       ( ( size_t ) ( 0x10000UL - portXMEM_START ) )
+    #endif
+    #ifndef portXMEM_XMCRA
+        #define portXMEM_XMCRA      _BV( SRE )
+    #endif
+    #ifndef portXMEM_XMCRB
+        #define portXMEM_XMCRB      0
+    #endif
+#endif
+
 /*-----------------------------------------------------------*/
 
 void initVariant(void);
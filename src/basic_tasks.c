@@ -0,0 +1,276 @@
+/*
+ * FreeRTOS Kernel V11.1.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers. That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "Arduino_FreeRTOS.h"
+#include "task.h"
+#include "basic_tasks.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* This entire source file will be skipped if the application is not configured
+ * to include basic tasks. This #if is closed at the very bottom of this file. */
+#if ( configUSE_BASIC_TASKS == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
+    #ifndef configBASIC_TASK_PRIORITY
+        #define configBASIC_TASK_PRIORITY       ( tskIDLE_PRIORITY + 1 )
+    #endif
+
+    #ifndef configBASIC_TASK_STACK_DEPTH
+        #define configBASIC_TASK_STACK_DEPTH    configMINIMAL_STACK_SIZE
+    #endif
+
+    #ifndef configBASIC_TASK_RUNNER_NAME
+        #define configBASIC_TASK_RUNNER_NAME    "Basic"
+    #endif
+
+    #if ( configTASK_NAMES_IN_PROGMEM == 1 )
+        static const char pcBasicTaskRunnerName[] PROGMEM = configBASIC_TASK_RUNNER_NAME;
+        #define basicRUNNER_NAME    pcBasicTaskRunnerName
+    #else
+        #define basicRUNNER_NAME    configBASIC_TASK_RUNNER_NAME
+    #endif
+
+    typedef struct BasicTaskDef_t
+    {
+        struct BasicTaskDef_t * pxNext; /**< The next basic task, in order of priority. */
+        BasicTaskFunction_t pxTaskCode; /**< The function to run. */
+        void * pvParameters;            /**< Passed to pxTaskCode. */
+        TickType_t xPeriod;             /**< The period of a periodic basic task, or 0. */
+        TickType_t xNextRelease;        /**< The tick count of the next periodic activation. */
+        UBaseType_t uxPriority;         /**< The priority among basic tasks. */
+        volatile uint8_t ucActivated;   /**< pdTRUE while activated and not yet run. */
+    } BasicTask_t;
+
+/* The basic tasks, highest priority first. */
+    PRIVILEGED_DATA static BasicTask_t * pxBasicTasks = NULL;
+
+    PRIVILEGED_DATA static TaskHandle_t xRunnerHandle = NULL;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Activate the periodic basic tasks that are due, and return the ticks until
+ * the next periodic activation, or portMAX_DELAY if there are none.
+ */
+    static TickType_t prvReleasePeriodicTasks( void )
+    {
+        BasicTask_t * pxBasicTask;
+        TickType_t xNow = xTaskGetTickCount();
+        TickType_t xWait = portMAX_DELAY;
+        TickType_t xRemaining;
+
+        /* The list is walked with the scheduler suspended, as xBasicTaskCreate()
+         * in a higher priority task could otherwise change a two byte link while
+         * it is being read. */
+        vTaskSuspendAll();
+        {
+            for( pxBasicTask = pxBasicTasks; pxBasicTask != NULL; pxBasicTask = pxBasicTask->pxNext )
+            {
+                if( pxBasicTask->xPeriod != 0U )
+                {
+                    /* Due when the release time is not in the future, allowing for overflow. */
+                    xRemaining = pxBasicTask->xNextRelease - xNow;
+
+                    if( ( xRemaining == 0U ) || ( xRemaining > pxBasicTask->xPeriod ) )
+                    {
+                        pxBasicTask->ucActivated = pdTRUE;
+                        pxBasicTask->xNextRelease += pxBasicTask->xPeriod;
+                        xRemaining = pxBasicTask->xNextRelease - xNow;
+
+                        /* If the runner has fallen more than a period behind, skip the missed activations. */
+                        if( ( xRemaining == 0U ) || ( xRemaining > pxBasicTask->xPeriod ) )
+                        {
+                            pxBasicTask->xNextRelease = xNow + pxBasicTask->xPeriod;
+                            xRemaining = pxBasicTask->xPeriod;
+                        }
+                    }
+
+                    if( xRemaining < xWait )
+                    {
+                        xWait = xRemaining;
+                    }
+                }
+            }
+        }
+        ( void ) xTaskResumeAll();
+
+        return xWait;
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Return the highest priority activated basic task, clearing its activation,
+ * or NULL if none are activated.
+ */
+    static BasicTask_t * prvTakeActivatedTask( void )
+    {
+        BasicTask_t * pxBasicTask;
+
+        taskENTER_CRITICAL();
+        {
+            for( pxBasicTask = pxBasicTasks; pxBasicTask != NULL; pxBasicTask = pxBasicTask->pxNext )
+            {
+                if( pxBasicTask->ucActivated != pdFALSE )
+                {
+                    pxBasicTask->ucActivated = pdFALSE;
+                    break;
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        return pxBasicTask;
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * The runner. Every basic task runs to completion on this stack, highest
+ * priority first, then the runner waits for an activation or a period.
+ */
+    static portTASK_FUNCTION( prvBasicTaskRunner, pvParameters )
+    {
+        BasicTask_t * pxBasicTask;
+        TickType_t xWait;
+
+        ( void ) pvParameters;
+
+        for( ; ; )
+        {
+            xWait = prvReleasePeriodicTasks();
+
+            /* A basic task activated while another runs is found by the next search. */
+            while( ( pxBasicTask = prvTakeActivatedTask() ) != NULL )
+            {
+                pxBasicTask->pxTaskCode( pxBasicTask->pvParameters );
+
+                /* Let a newly due periodic basic task of higher priority run next. */
+                xWait = prvReleasePeriodicTasks();
+            }
+
+            ( void ) ulTaskNotifyTake( pdTRUE, xWait );
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    BasicTaskHandle_t xBasicTaskCreate( BasicTaskFunction_t pxTaskCode,
+                                        void * pvParameters,
+                                        UBaseType_t uxPriority,
+                                        TickType_t xPeriod )
+    {
+        BasicTask_t * pxNewBasicTask;
+        BasicTask_t ** ppxPosition;
+
+        configASSERT( pxTaskCode );
+
+        if( xRunnerHandle == NULL )
+        {
+            if( xTaskCreate( prvBasicTaskRunner,
+                             basicRUNNER_NAME,
+                             configBASIC_TASK_STACK_DEPTH,
+                             NULL,
+                             configBASIC_TASK_PRIORITY,
+                             &xRunnerHandle ) != pdPASS )
+            {
+                return NULL;
+            }
+        }
+
+        pxNewBasicTask = ( BasicTask_t * ) pvPortMalloc( sizeof( BasicTask_t ) );
+
+        if( pxNewBasicTask != NULL )
+        {
+            pxNewBasicTask->pxTaskCode = pxTaskCode;
+            pxNewBasicTask->pvParameters = pvParameters;
+            pxNewBasicTask->xPeriod = xPeriod;
+            pxNewBasicTask->uxPriority = uxPriority;
+            pxNewBasicTask->ucActivated = pdFALSE;
+
+            /* Link the basic task in after those of the same or higher priority. */
+            vTaskSuspendAll();
+            {
+                pxNewBasicTask->xNextRelease = xTaskGetTickCount() + xPeriod;
+
+                for( ppxPosition = &pxBasicTasks; *ppxPosition != NULL; ppxPosition = &( ( *ppxPosition )->pxNext ) )
+                {
+                    if( ( *ppxPosition )->uxPriority < uxPriority )
+                    {
+                        break;
+                    }
+                }
+
+                pxNewBasicTask->pxNext = *ppxPosition;
+                *ppxPosition = pxNewBasicTask;
+            }
+            ( void ) xTaskResumeAll();
+
+            /* Let the runner include a new period in its wait. */
+            if( xPeriod != 0U )
+            {
+                xTaskNotifyGive( xRunnerHandle );
+            }
+        }
+
+        return ( BasicTaskHandle_t ) pxNewBasicTask;
+    }
+/*-----------------------------------------------------------*/
+
+    void vBasicTaskActivate( BasicTaskHandle_t xBasicTask )
+    {
+        configASSERT( xBasicTask );
+
+        ( ( BasicTask_t * ) xBasicTask )->ucActivated = pdTRUE;
+        xTaskNotifyGive( xRunnerHandle );
+    }
+/*-----------------------------------------------------------*/
+
+    void vBasicTaskActivateFromISR( BasicTaskHandle_t xBasicTask,
+                                    BaseType_t * pxHigherPriorityTaskWoken )
+    {
+        configASSERT( xBasicTask );
+
+        ( ( BasicTask_t * ) xBasicTask )->ucActivated = pdTRUE;
+        vTaskNotifyGiveFromISR( xRunnerHandle, pxHigherPriorityTaskWoken );
+    }
+/*-----------------------------------------------------------*/
+
+    TaskHandle_t xBasicTaskGetRunnerHandle( void )
+    {
+        return xRunnerHandle;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( configUSE_BASIC_TASKS == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) */
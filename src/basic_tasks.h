@@ -0,0 +1,149 @@
+/*
+ * FreeRTOS Kernel V11.1.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+#ifndef BASIC_TASKS_H
+#define BASIC_TASKS_H
+
+#ifndef INC_ARDUINO_FREERTOS_H
+    #error "include Arduino_FreeRTOS.h" must appear in source files before "include basic_tasks.h"
+#endif
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * A basic task is a function that runs to completion each time it is
+ * activated, in the style of an OSEK basic task. It never blocks, so all basic
+ * tasks share the stack of one FreeRTOS task, the basic task runner, and each
+ * costs only a few bytes of RAM rather than a TCB and a private stack.
+ *
+ * A basic task is activated with vBasicTaskActivate(), from a task, a timer
+ * callback or an interrupt, or periodically. The runner runs the highest
+ * priority activated basic task first. Basic tasks don't preempt each other,
+ * but the runner is preempted by FreeRTOS tasks of higher priority than
+ * configBASIC_TASK_PRIORITY.
+ *
+ * configUSE_BASIC_TASKS must be set to 1 in FreeRTOSConfig.h, and the stack
+ * of the runner set with configBASIC_TASK_STACK_DEPTH, large enough for the
+ * deepest basic task.
+ */
+
+/**
+ * basic_tasks.h
+ *
+ * Type by which basic tasks are referenced.
+ */
+struct BasicTaskDef_t;
+typedef struct BasicTaskDef_t * BasicTaskHandle_t;
+
+/**
+ * basic_tasks.h
+ *
+ * The function of a basic task. It must return, and must not block.
+ */
+typedef void (* BasicTaskFunction_t)( void * pvParameters );
+
+/**
+ * basic_tasks.h
+ * @code{c}
+ * BasicTaskHandle_t xBasicTaskCreate( BasicTaskFunction_t pxTaskCode, void * pvParameters, UBaseType_t uxPriority, TickType_t xPeriod );
+ * @endcode
+ *
+ * Create a basic task, and the runner if it hasn't been created yet.
+ *
+ * @param pxTaskCode The function run on each activation.
+ *
+ * @param pvParameters Passed to pxTaskCode.
+ *
+ * @param uxPriority The priority among basic tasks only. Higher numbers run first.
+ *
+ * @param xPeriod If not 0, the basic task is also activated every xPeriod
+ * ticks, starting xPeriod ticks from now.
+ *
+ * @return The handle of the basic task, or NULL if there wasn't enough heap.
+ *
+ * Example usage:
+ * @code{c}
+ * void vBlink( void * pvParameters )
+ * {
+ *     digitalWrite( LED_BUILTIN, !digitalRead( LED_BUILTIN ) );
+ * }
+ *
+ * xBasicTaskCreate( vBlink, NULL, 1, pdMS_TO_TICKS( 500 ) );
+ * @endcode
+ */
+BasicTaskHandle_t xBasicTaskCreate( BasicTaskFunction_t pxTaskCode,
+                                    void * pvParameters,
+                                    UBaseType_t uxPriority,
+                                    TickType_t xPeriod ) PRIVILEGED_FUNCTION;
+
+/**
+ * basic_tasks.h
+ * @code{c}
+ * void vBasicTaskActivate( BasicTaskHandle_t xBasicTask );
+ * @endcode
+ *
+ * Activate a basic task, so it runs once. An activation while the basic task
+ * is already activated, and hasn't started running, is not counted again.
+ */
+void vBasicTaskActivate( BasicTaskHandle_t xBasicTask ) PRIVILEGED_FUNCTION;
+
+/**
+ * basic_tasks.h
+ * @code{c}
+ * void vBasicTaskActivateFromISR( BasicTaskHandle_t xBasicTask, BaseType_t * pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Activate a basic task from an interrupt. *pxHigherPriorityTaskWoken is set
+ * to pdTRUE if the runner should run now, in which case the interrupt should
+ * call portYIELD_FROM_ISR().
+ */
+void vBasicTaskActivateFromISR( BasicTaskHandle_t xBasicTask,
+                                BaseType_t * pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * basic_tasks.h
+ * @code{c}
+ * TaskHandle_t xBasicTaskGetRunnerHandle( void );
+ * @endcode
+ *
+ * @return The handle of the FreeRTOS task that runs the basic tasks, for
+ * example to check its stack with uxTaskGetStackHighWaterMark().
+ */
+TaskHandle_t xBasicTaskGetRunnerHandle( void ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* BASIC_TASKS_H */
@@ -50,17 +50,127 @@
 
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
 
-#if( configSUPPORT_DYNAMIC_ALLOCATION > 0 )
+#if( configSUPPORT_DYNAMIC_ALLOCATION > 0 ) && ( configUSE_HEAP_AVR == 0 )
+
+#if ( configSTACK_ALLOCATION_FROM_SEPARATE_HEAP == 1 )
+    #error configSTACK_ALLOCATION_FROM_SEPARATE_HEAP needs configUSE_HEAP_AVR.
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* The avr-libc malloc() free list, and the top of the heap, see stdlib_private.h.
+ * Each chunk starts with its size, not counting the size itself. */
+struct __freelist
+{
+    size_t sz;
+    struct __freelist * nx;
+};
+
+extern struct __freelist * __flp;
+extern char * __brkval;
+
+#define heapCHUNK_HEADER_SIZE    ( sizeof( size_t ) )
+
+/* The size of an allocated chunk, including its header. */
+#define heapCHUNK_SIZE( pv )     ( *( ( size_t * ) ( pv ) - 1 ) + heapCHUNK_HEADER_SIZE )
+
+/* Free bytes, kept up to date by pvPortMalloc() and vPortFree(). malloc() called
+ * directly by the Arduino libraries is only counted when the heap is walked. */
+static size_t xFreeBytesRemaining = 0U;
+static size_t xMinimumEverFreeBytesRemaining = 0U;
+static uint8_t ucFreeBytesValid = pdFALSE;
+
+static size_t xNumberOfSuccessfulAllocations = 0U;
+static size_t xNumberOfSuccessfulFrees = 0U;
 
 /*-----------------------------------------------------------*/
 
+/*
+ * Walk the malloc() free list, adding the unused space above the top of the
+ * heap as a free block. Returns the free bytes, and the block sizes if
+ * pxHeapStats isn't NULL. Called with the scheduler suspended.
+ */
+static size_t prvWalkHeap( HeapStats_t * pxHeapStats )
+{
+    const struct __freelist * pxChunk;
+    size_t xFreeBytes;
+    size_t xBlockSize;
+    size_t xBlocks = 0U;
+    size_t xLargest = 0U;
+    size_t xSmallest = ( size_t ) -1;
+    char * pcTop = ( __brkval != NULL ) ? __brkval : __malloc_heap_start;
+
+    xFreeBytes = ( __malloc_heap_end > pcTop ) ? ( size_t ) ( __malloc_heap_end - pcTop ) : 0U;
+
+    if( xFreeBytes != 0U )
+    {
+        xBlocks = 1U;
+        xLargest = xFreeBytes;
+        xSmallest = xFreeBytes;
+    }
+
+    for( pxChunk = __flp; pxChunk != NULL; pxChunk = pxChunk->nx )
+    {
+        xBlockSize = pxChunk->sz + heapCHUNK_HEADER_SIZE;
+        xFreeBytes += xBlockSize;
+        xBlocks++;
+
+        if( xBlockSize > xLargest )
+        {
+            xLargest = xBlockSize;
+        }
+
+        if( xBlockSize < xSmallest )
+        {
+            xSmallest = xBlockSize;
+        }
+    }
+
+    if( pxHeapStats != NULL )
+    {
+        pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytes;
+        pxHeapStats->xSizeOfLargestFreeBlockInBytes = xLargest;
+        pxHeapStats->xSizeOfSmallestFreeBlockInBytes = ( xBlocks != 0U ) ? xSmallest : 0U;
+        pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+    }
+
+    /* Bring the running count up to date. */
+    if( ( ucFreeBytesValid == pdFALSE ) || ( xFreeBytes < xMinimumEverFreeBytesRemaining ) )
+    {
+        xMinimumEverFreeBytesRemaining = xFreeBytes;
+    }
+
+    xFreeBytesRemaining = xFreeBytes;
+    ucFreeBytesValid = pdTRUE;
+
+    return xFreeBytes;
+}
+/*-----------------------------------------------------------*/
+
 void * pvPortMalloc( size_t xWantedSize )
 {
     void * pvReturn;
 
     vTaskSuspendAll();
     {
+        if( ucFreeBytesValid == pdFALSE )
+        {
+            ( void ) prvWalkHeap( NULL );
+        }
+
         pvReturn = malloc( xWantedSize );
+
+        if( pvReturn != NULL )
+        {
+            xNumberOfSuccessfulAllocations++;
+            xFreeBytesRemaining -= heapCHUNK_SIZE( pvReturn );
+
+            if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+            {
+                xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+            }
+        }
+
         traceMALLOC( pvReturn, xWantedSize );
     }
     ( void ) xTaskResumeAll();
@@ -84,6 +194,8 @@ void vPortFree( void * pv )
     {
         vTaskSuspendAll();
         {
+            xNumberOfSuccessfulFrees++;
+            xFreeBytesRemaining += heapCHUNK_SIZE( pv );
             free( pv );
             traceFREE( pv, 0 );
         }
@@ -92,6 +204,39 @@ void vPortFree( void * pv )
 }
 /*-----------------------------------------------------------*/
 
+size_t xPortGetFreeHeapSize( void )
+{
+    size_t xFreeBytes;
+
+    vTaskSuspendAll();
+    {
+        xFreeBytes = prvWalkHeap( NULL );
+    }
+    ( void ) xTaskResumeAll();
+
+    return xFreeBytes;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+    return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t * pxHeapStats )
+{
+    vTaskSuspendAll();
+    {
+        ( void ) prvWalkHeap( pxHeapStats );
+        pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+        pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+    }
+    ( void ) xTaskResumeAll();
+}
+/*-----------------------------------------------------------*/
+
 /*
  * Reset the state in this file. This state is normally initialized at start up.
  * This function must be called by the application before restarting the
@@ -99,7 +244,33 @@ void vPortFree( void * pv )
  */
 void vPortHeapResetState( void )
 {
-    /* No state needs to be re-initialised in heap_3. */
+    xFreeBytesRemaining = 0U;
+    xMinimumEverFreeBytesRemaining = 0U;
+    ucFreeBytesValid = pdFALSE;
+    xNumberOfSuccessfulAllocations = 0U;
+    xNumberOfSuccessfulFrees = 0U;
 }
 /*-----------------------------------------------------------*/
-#endif /* ( configSUPPORT_DYNAMIC_ALLOCATION > 0 ) */
+
+#if ( configRECLAIM_MAIN_STACK == 1 )
+
+/*
+ * Called by xPortStartScheduler() as the first task starts. main() will not
+ * run again, so move the end of the heap up over its stack, leaving only the
+ * interrupt stack. malloc() reads __malloc_heap_end each time it extends the
+ * heap, so nothing else needs to change.
+ */
+void vPortHeapAddMainStack( void )
+{
+    char * pcHeapEnd = ( char * ) ( RAMEND + 1 - configISR_STACK_SIZE );
+
+    if( pcHeapEnd > __malloc_heap_end )
+    {
+        xFreeBytesRemaining += ( size_t ) ( pcHeapEnd - __malloc_heap_end );
+        __malloc_heap_end = pcHeapEnd;
+    }
+}
+
+#endif /* configRECLAIM_MAIN_STACK == 1 */
+/*-----------------------------------------------------------*/
+#endif /* ( configSUPPORT_DYNAMIC_ALLOCATION > 0 ) && ( configUSE_HEAP_AVR == 0 ) */
@@ -0,0 +1,623 @@
+/*
+ * FreeRTOS Kernel V11.1.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+
+/*
+ * Implementation of pvPortMalloc() and vPortFree() for the AVR, selected with
+ * configUSE_HEAP_AVR as an alternative to heap_3.c.
+ *
+ * The heap is a configTOTAL_HEAP_SIZE array, so malloc() is left for the
+ * Arduino libraries. More regions can be added with vPortDefineHeapRegions().
+ * With portUSE_XMEM, the external SRAM of the ATmega640/1280/2560 is a second
+ * heap, with its own free lists. pvPortMalloc() prefers the internal RAM, and
+ * pvPortMallocExternal() and task stacks prefer the external RAM.
+ *
+ * Each block has a 2 byte header holding its size, which is a multiple of 4
+ * bytes, leaving the two low bits for flags. A free block also holds the links
+ * of its free list, and repeats its size in its last two bytes, so that a
+ * block being freed is merged with both of its neighbours.
+ *
+ * Free blocks are kept in one list for each power of two size. Any block in
+ * the list above the size requested is big enough, so finding a block only
+ * tests a bitmap of the non-empty lists. Allocation and free take a bounded
+ * time, however long the application has run, so they use a critical section
+ * rather than suspending the scheduler.
+ *
+ * See heap_1.c, heap_2.c and heap_4.c for alternative implementations, and the
+ * memory management pages of https://www.FreeRTOS.org for more information.
+ */
+
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers.  That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "Arduino_FreeRTOS.h"
+#include "task.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#if ( configSUPPORT_DYNAMIC_ALLOCATION > 0 ) && ( configUSE_HEAP_AVR == 1 )
+
+#ifndef configTOTAL_HEAP_SIZE
+    #error configTOTAL_HEAP_SIZE must be defined to use heap_avr.c
+#endif
+
+/*-----------------------------------------------------------*/
+
+/* Block header flags, in the two low bits of the block size. */
+#define heapBLOCK_USED              ( ( uint16_t ) 0x0001 )
+#define heapPREVIOUS_FREE           ( ( uint16_t ) 0x0002 )
+#define heapSIZE_MASK               ( ( uint16_t ) 0xfffc )
+
+#define heapHEADER_SIZE             ( ( uint16_t ) sizeof( uint16_t ) )
+
+/* The header, two free list links and the size at the end of a free block. */
+#define heapMINIMUM_BLOCK_SIZE      ( ( uint16_t ) 8 )
+
+/* One free list for each power of two block size, from 8 bytes up to the largest block. */
+#define heapNUMBER_OF_LISTS         13
+
+/* The largest request that can be rounded up to a block size without overflow. */
+#define heapMAXIMUM_REQUEST         ( ( size_t ) ( heapSIZE_MASK - heapHEADER_SIZE ) )
+
+/* A free block. The size is repeated in the last two bytes of the block. */
+typedef struct A_FREE_BLOCK
+{
+    uint16_t usHeader;
+    struct A_FREE_BLOCK * pxNextFree;
+    struct A_FREE_BLOCK * pxPreviousFree;
+} FreeBlock_t;
+
+#define heapHEADER( pucBlock )      ( *( uint16_t * ) ( pucBlock ) )
+#define heapFOOTER( pucBlock, usSize )  ( *( uint16_t * ) ( ( pucBlock ) + ( usSize ) - sizeof( uint16_t ) ) )
+
+/*-----------------------------------------------------------*/
+
+/* Allocate the memory for the heap. */
+#if ( configAPPLICATION_ALLOCATED_HEAP == 1 )
+    extern uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#else
+    static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
+#endif
+
+/* The free lists of a heap, and a bitmap of the lists that are not empty. */
+typedef struct A_HEAP
+{
+    FreeBlock_t * pxFreeLists[ heapNUMBER_OF_LISTS ];
+    uint16_t usFreeListBitmap;
+} Heap_t;
+
+/* The heap a block belongs to is found from its address. */
+#if defined( portUSE_XMEM )
+    #define heapINTERNAL            0
+    #define heapEXTERNAL            1
+    #define heapNUMBER_OF_HEAPS     2
+    #define heapOF( pucBlock )      ( &xHeaps[ ( ( uint16_t ) ( pucBlock ) >= ( uint16_t ) portXMEM_START ) ? heapEXTERNAL : heapINTERNAL ] )
+#else
+    #define heapINTERNAL            0
+    #define heapEXTERNAL            0
+    #define heapNUMBER_OF_HEAPS     1
+    #define heapOF( pucBlock )      ( &xHeaps[ heapINTERNAL ] )
+#endif
+
+static Heap_t xHeaps[ heapNUMBER_OF_HEAPS ];
+
+static uint8_t ucHeapInitialised = pdFALSE;
+
+/* Keeps track of the number of free bytes remaining, but says nothing about
+ * fragmentation. */
+static size_t xFreeBytesRemaining = 0U;
+static size_t xMinimumEverFreeBytesRemaining = 0U;
+static size_t xNumberOfSuccessfulAllocations = 0U;
+static size_t xNumberOfSuccessfulFrees = 0U;
+
+#if ( configRECLAIM_MAIN_STACK == 1 )
+    /* Set when the scheduler starts, until the main() stack is added as a region. */
+    static uint8_t ucMainStackPending = pdFALSE;
+
+    static void prvAddMainStack( void );
+#endif
+
+/*-----------------------------------------------------------*/
+
+/*
+ * The free list for a block size, the position of its highest set bit less 3.
+ */
+static uint8_t prvListIndex( uint16_t usBlockSize )
+{
+    uint8_t ucIndex;
+    uint8_t ucBits;
+
+    if( usBlockSize >= 256U )
+    {
+        ucIndex = 5;
+        ucBits = ( uint8_t ) ( usBlockSize >> 8 );
+    }
+    else
+    {
+        ucIndex = 0;
+        ucBits = ( uint8_t ) ( usBlockSize >> 3 );
+    }
+
+    while( ucBits > 1 )
+    {
+        ucBits >>= 1;
+        ucIndex++;
+    }
+
+    return ucIndex;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Mark a block free, and put it at the start of the free list for its size.
+ * The block following it is told that its neighbour is free.
+ */
+static void prvInsertFreeBlock( uint8_t * pucBlock, uint16_t usBlockSize )
+{
+    FreeBlock_t * pxBlock = ( FreeBlock_t * ) pucBlock;
+    Heap_t * pxHeap = heapOF( pucBlock );
+    uint8_t ucIndex = prvListIndex( usBlockSize );
+
+    pxBlock->usHeader = usBlockSize;
+    heapFOOTER( pucBlock, usBlockSize ) = usBlockSize;
+    heapHEADER( pucBlock + usBlockSize ) |= heapPREVIOUS_FREE;
+
+    pxBlock->pxPreviousFree = NULL;
+    pxBlock->pxNextFree = pxHeap->pxFreeLists[ ucIndex ];
+
+    if( pxBlock->pxNextFree != NULL )
+    {
+        pxBlock->pxNextFree->pxPreviousFree = pxBlock;
+    }
+
+    pxHeap->pxFreeLists[ ucIndex ] = pxBlock;
+    pxHeap->usFreeListBitmap |= ( uint16_t ) ( 1U << ucIndex );
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Take a free block out of the free list for its size.
+ */
+static void prvRemoveFreeBlock( FreeBlock_t * pxBlock )
+{
+    if( pxBlock->pxNextFree != NULL )
+    {
+        pxBlock->pxNextFree->pxPreviousFree = pxBlock->pxPreviousFree;
+    }
+
+    if( pxBlock->pxPreviousFree != NULL )
+    {
+        pxBlock->pxPreviousFree->pxNextFree = pxBlock->pxNextFree;
+    }
+    else
+    {
+        Heap_t * pxHeap = heapOF( pxBlock );
+        uint8_t ucIndex = prvListIndex( pxBlock->usHeader & heapSIZE_MASK );
+
+        pxHeap->pxFreeLists[ ucIndex ] = pxBlock->pxNextFree;
+
+        if( pxBlock->pxNextFree == NULL )
+        {
+            pxHeap->usFreeListBitmap &= ( uint16_t ) ~( 1U << ucIndex );
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Add a region of RAM to the heap, as one free block followed by a used
+ * block of size 0, which stops the last block being merged past the end.
+ */
+static void prvAddRegion( uint8_t * pucStart, size_t xSize )
+{
+    uint16_t usBlockSize;
+
+    if( xSize < ( size_t ) ( heapMINIMUM_BLOCK_SIZE + heapHEADER_SIZE ) )
+    {
+        return;
+    }
+
+    usBlockSize = ( uint16_t ) ( xSize - heapHEADER_SIZE ) & heapSIZE_MASK;
+
+    heapHEADER( pucStart + usBlockSize ) = heapBLOCK_USED;
+    prvInsertFreeBlock( pucStart, usBlockSize );
+
+    xFreeBytesRemaining += usBlockSize;
+    xMinimumEverFreeBytesRemaining += usBlockSize;
+}
+/*-----------------------------------------------------------*/
+
+static void prvHeapInit( void )
+{
+    ucHeapInitialised = pdTRUE;
+    prvAddRegion( ucHeap, configTOTAL_HEAP_SIZE );
+
+#if defined( portUSE_XMEM )
+    /* Enable the external memory interface, and add the external SRAM. */
+    XMCRB = portXMEM_XMCRB;
+    XMCRA = portXMEM_XMCRA;
+    prvAddRegion( ( uint8_t * ) portXMEM_START, portXMEM_SIZE );
+#endif
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Find a free block of at least usWantedSize bytes in a heap. The first block
+ * in the list for this size is tried, then the first block in the lists for
+ * larger sizes, all of which will fit.
+ */
+static FreeBlock_t * prvFindBlock( const Heap_t * pxHeap, uint16_t usWantedSize )
+{
+    FreeBlock_t * pxBlock;
+    uint16_t usBitmap;
+    uint8_t ucIndex;
+
+    ucIndex = prvListIndex( usWantedSize );
+    pxBlock = pxHeap->pxFreeLists[ ucIndex ];
+
+    if( ( pxBlock == NULL ) || ( ( pxBlock->usHeader & heapSIZE_MASK ) < usWantedSize ) )
+    {
+        pxBlock = NULL;
+        usBitmap = pxHeap->usFreeListBitmap >> ++ucIndex;
+
+        while( usBitmap != 0 )
+        {
+            if( usBitmap & 0x0001 )
+            {
+                pxBlock = pxHeap->pxFreeLists[ ucIndex ];
+                break;
+            }
+
+            usBitmap >>= 1;
+            ucIndex++;
+        }
+    }
+
+    return pxBlock;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Allocate from the preferred heap, or from the other heap if there is no
+ * block big enough.
+ */
+static void * prvMalloc( size_t xWantedSize, uint8_t ucHeapIndex )
+{
+    void * pvReturn = NULL;
+    FreeBlock_t * pxBlock = NULL;
+    uint16_t usWantedSize;
+    uint16_t usBlockSize;
+    uint8_t ucTries;
+
+    if( ( xWantedSize > 0 ) && ( xWantedSize <= heapMAXIMUM_REQUEST ) )
+    {
+        usWantedSize = ( ( uint16_t ) xWantedSize + heapHEADER_SIZE + 3U ) & heapSIZE_MASK;
+
+        if( usWantedSize < heapMINIMUM_BLOCK_SIZE )
+        {
+            usWantedSize = heapMINIMUM_BLOCK_SIZE;
+        }
+
+        portENTER_CRITICAL();
+        {
+            if( ucHeapInitialised == pdFALSE )
+            {
+                prvHeapInit();
+            }
+
+#if ( configRECLAIM_MAIN_STACK == 1 )
+            if( ucMainStackPending != pdFALSE )
+            {
+                prvAddMainStack();
+            }
+#endif
+
+            for( ucTries = 0; ( pxBlock == NULL ) && ( ucTries < heapNUMBER_OF_HEAPS ); ucTries++ )
+            {
+                pxBlock = prvFindBlock( &xHeaps[ ucHeapIndex ], usWantedSize );
+                ucHeapIndex = ( heapNUMBER_OF_HEAPS - 1 ) - ucHeapIndex;
+            }
+
+            if( pxBlock != NULL )
+            {
+                uint8_t * pucBlock = ( uint8_t * ) pxBlock;
+
+                prvRemoveFreeBlock( pxBlock );
+                usBlockSize = pxBlock->usHeader & heapSIZE_MASK;
+
+                if( ( usBlockSize - usWantedSize ) >= heapMINIMUM_BLOCK_SIZE )
+                {
+                    /* Split the block, and return the remainder to the free lists. */
+                    prvInsertFreeBlock( pucBlock + usWantedSize, usBlockSize - usWantedSize );
+                    usBlockSize = usWantedSize;
+                }
+                else
+                {
+                    heapHEADER( pucBlock + usBlockSize ) &= ( uint16_t ) ~heapPREVIOUS_FREE;
+                }
+
+                /* The block before a free block is never free, as they are merged. */
+                pxBlock->usHeader = usBlockSize | heapBLOCK_USED;
+
+                xFreeBytesRemaining -= usBlockSize;
+                xNumberOfSuccessfulAllocations++;
+
+                if( xFreeBytesRemaining < xMinimumEverFreeBytesRemaining )
+                {
+                    xMinimumEverFreeBytesRemaining = xFreeBytesRemaining;
+                }
+
+                pvReturn = ( void * ) ( pucBlock + heapHEADER_SIZE );
+            }
+
+            traceMALLOC( pvReturn, xWantedSize );
+        }
+        portEXIT_CRITICAL();
+    }
+
+    #if ( configUSE_MALLOC_FAILED_HOOK == 1 )
+    {
+        if( pvReturn == NULL )
+        {
+            vApplicationMallocFailedHook();
+        }
+    }
+    #endif
+
+    return pvReturn;
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortMalloc( size_t xWantedSize )
+{
+    return prvMalloc( xWantedSize, heapINTERNAL );
+}
+/*-----------------------------------------------------------*/
+
+void * pvPortMallocExternal( size_t xWantedSize )
+{
+    return prvMalloc( xWantedSize, heapEXTERNAL );
+}
+/*-----------------------------------------------------------*/
+
+#if ( configSTACK_ALLOCATION_FROM_SEPARATE_HEAP == 1 )
+
+void * pvPortMallocStack( size_t xSize )
+{
+    return prvMalloc( xSize, heapEXTERNAL );
+}
+/*-----------------------------------------------------------*/
+
+void vPortFreeStack( void * pv )
+{
+    vPortFree( pv );
+}
+/*-----------------------------------------------------------*/
+
+#endif /* configSTACK_ALLOCATION_FROM_SEPARATE_HEAP == 1 */
+
+void vPortFree( void * pv )
+{
+    uint8_t * pucBlock;
+    uint8_t * pucNext;
+    uint16_t usBlockSize;
+
+    if( pv != NULL )
+    {
+        pucBlock = ( uint8_t * ) pv - heapHEADER_SIZE;
+
+        configASSERT( ( heapHEADER( pucBlock ) & heapBLOCK_USED ) != 0 );
+
+        portENTER_CRITICAL();
+        {
+            usBlockSize = heapHEADER( pucBlock ) & heapSIZE_MASK;
+            xFreeBytesRemaining += usBlockSize;
+            xNumberOfSuccessfulFrees++;
+            traceFREE( pv, usBlockSize );
+
+            /* Merge with the following block. */
+            pucNext = pucBlock + usBlockSize;
+
+            if( ( heapHEADER( pucNext ) & heapBLOCK_USED ) == 0 )
+            {
+                prvRemoveFreeBlock( ( FreeBlock_t * ) pucNext );
+                usBlockSize += heapHEADER( pucNext ) & heapSIZE_MASK;
+            }
+
+            /* Merge with the preceding block, found from the size at its end. */
+            if( ( heapHEADER( pucBlock ) & heapPREVIOUS_FREE ) != 0 )
+            {
+                pucBlock -= *( uint16_t * ) ( pucBlock - sizeof( uint16_t ) );
+                prvRemoveFreeBlock( ( FreeBlock_t * ) pucBlock );
+                usBlockSize += heapHEADER( pucBlock ) & heapSIZE_MASK;
+            }
+
+            prvInsertFreeBlock( pucBlock, usBlockSize );
+        }
+        portEXIT_CRITICAL();
+    }
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Add more regions of RAM to the heap, as for heap_5.c. The array is ended by
+ * a region of size 0. Unlike heap_5.c, regions can be added at any time, and
+ * in any order, as long as they don't overlap. A region at or above
+ * portXMEM_START belongs to the external heap.
+ */
+void vPortDefineHeapRegions( const HeapRegion_t * const pxHeapRegions )
+{
+    const HeapRegion_t * pxRegion;
+
+    portENTER_CRITICAL();
+    {
+        if( ucHeapInitialised == pdFALSE )
+        {
+            prvHeapInit();
+        }
+
+        for( pxRegion = pxHeapRegions; pxRegion->xSizeInBytes != 0U; pxRegion++ )
+        {
+            prvAddRegion( pxRegion->pucStartAddress, pxRegion->xSizeInBytes );
+        }
+    }
+    portEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetFreeHeapSize( void )
+{
+    return xFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+size_t xPortGetMinimumEverFreeHeapSize( void )
+{
+    return xMinimumEverFreeBytesRemaining;
+}
+/*-----------------------------------------------------------*/
+
+void vPortGetHeapStats( HeapStats_t * pxHeapStats )
+{
+    const FreeBlock_t * pxBlock;
+    size_t xBlockSize;
+    size_t xBlocks = 0U;
+    size_t xLargest = 0U;
+    size_t xSmallest = ( size_t ) -1;
+    uint8_t ucIndex;
+    uint8_t ucHeapIndex;
+
+    vTaskSuspendAll();
+    {
+        for( ucHeapIndex = 0; ucHeapIndex < heapNUMBER_OF_HEAPS; ucHeapIndex++ )
+        {
+            for( ucIndex = 0; ucIndex < heapNUMBER_OF_LISTS; ucIndex++ )
+            {
+                for( pxBlock = xHeaps[ ucHeapIndex ].pxFreeLists[ ucIndex ]; pxBlock != NULL; pxBlock = pxBlock->pxNextFree )
+                {
+                    xBlockSize = pxBlock->usHeader & heapSIZE_MASK;
+                    xBlocks++;
+
+                    if( xBlockSize > xLargest )
+                    {
+                        xLargest = xBlockSize;
+                    }
+
+                    if( xBlockSize < xSmallest )
+                    {
+                        xSmallest = xBlockSize;
+                    }
+                }
+            }
+        }
+    }
+    ( void ) xTaskResumeAll();
+
+    pxHeapStats->xSizeOfLargestFreeBlockInBytes = xLargest;
+    pxHeapStats->xSizeOfSmallestFreeBlockInBytes = ( xBlocks != 0U ) ? xSmallest : 0U;
+    pxHeapStats->xNumberOfFreeBlocks = xBlocks;
+
+    portENTER_CRITICAL();
+    {
+        pxHeapStats->xAvailableHeapSpaceInBytes = xFreeBytesRemaining;
+        pxHeapStats->xMinimumEverFreeBytesRemaining = xMinimumEverFreeBytesRemaining;
+        pxHeapStats->xNumberOfSuccessfulAllocations = xNumberOfSuccessfulAllocations;
+        pxHeapStats->xNumberOfSuccessfulFrees = xNumberOfSuccessfulFrees;
+    }
+    portEXIT_CRITICAL();
+}
+/*-----------------------------------------------------------*/
+
+#if ( configRECLAIM_MAIN_STACK == 1 )
+
+/*
+ * Called by xPortStartScheduler() as the first task starts. main() will not
+ * run again, but xPortStartScheduler() is still running on its stack, so the
+ * region is only added by the first allocation, which runs on a task stack.
+ */
+void vPortHeapAddMainStack( void )
+{
+    ucMainStackPending = pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Add the main() stack above the malloc() heap as a region, leaving only the
+ * interrupt stack. Called from prvMalloc() in a critical section.
+ */
+static void prvAddMainStack( void )
+{
+    uint8_t * pucStart = ( uint8_t * ) __malloc_heap_end;
+    uint8_t * pucEnd = ( uint8_t * ) ( RAMEND + 1 - configISR_STACK_SIZE );
+
+    ucMainStackPending = pdFALSE;
+
+    if( ( pucStart != NULL ) && ( pucStart < pucEnd ) )
+    {
+        prvAddRegion( pucStart, ( size_t ) ( pucEnd - pucStart ) );
+    }
+}
+
+#endif /* configRECLAIM_MAIN_STACK == 1 */
+/*-----------------------------------------------------------*/
+
+/*
+ * Reset the state in this file. This state is normally initialized at start up.
+ * This function must be called by the application before restarting the
+ * scheduler.
+ */
+void vPortHeapResetState( void )
+{
+    uint8_t ucIndex;
+    uint8_t ucHeapIndex;
+
+    for( ucHeapIndex = 0; ucHeapIndex < heapNUMBER_OF_HEAPS; ucHeapIndex++ )
+    {
+        for( ucIndex = 0; ucIndex < heapNUMBER_OF_LISTS; ucIndex++ )
+        {
+            xHeaps[ ucHeapIndex ].pxFreeLists[ ucIndex ] = NULL;
+        }
+
+        xHeaps[ ucHeapIndex ].usFreeListBitmap = 0;
+    }
+
+    ucHeapInitialised = pdFALSE;
+#if ( configRECLAIM_MAIN_STACK == 1 )
+    ucMainStackPending = pdFALSE;
+#endif
+    xFreeBytesRemaining = 0U;
+    xMinimumEverFreeBytesRemaining = 0U;
+    xNumberOfSuccessfulAllocations = 0U;
+    xNumberOfSuccessfulFrees = 0U;
+}
+/*-----------------------------------------------------------*/
+#endif /* ( configSUPPORT_DYNAMIC_ALLOCATION > 0 ) && ( configUSE_HEAP_AVR == 1 ) */
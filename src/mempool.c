@@ -0,0 +1,246 @@
+/*
+ * FreeRTOS Kernel V11.1.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+/* Standard includes. */
+#include <stdlib.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers. That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "Arduino_FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "mempool.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* Pools wait on a counting semaphore, so need dynamic allocation and counting
+ * semaphores. This #if is closed at the very bottom of this file. */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configUSE_COUNTING_SEMAPHORES == 1 )
+
+/* A free block, linked through its first bytes. */
+    typedef struct MemPoolBlock_t
+    {
+        struct MemPoolBlock_t * pxNext;
+    } MemPoolBlock_t;
+
+    typedef struct MemPoolDef_t
+    {
+        MemPoolBlock_t * pxFreeBlocks;  /**< The free blocks, most recently given first. */
+        SemaphoreHandle_t xBlocksFree;  /**< Counts the free blocks that have not been claimed, and holds tasks waiting for one. */
+        UBaseType_t uxBlocks;           /**< The number of blocks in the pool. */
+        UBaseType_t uxFreeCount;        /**< The number of blocks in the free list. */
+        UBaseType_t uxMinimumFreeCount; /**< The fewest blocks there have been in the free list. */
+    } MemPool_t;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Unlink the first free block. The caller has claimed it from the semaphore,
+ * so there is always one, and interrupts must be masked.
+ */
+    static void * prvPopBlock( MemPool_t * pxPool )
+    {
+        MemPoolBlock_t * pxBlock = pxPool->pxFreeBlocks;
+
+        pxPool->pxFreeBlocks = pxBlock->pxNext;
+
+        if( --pxPool->uxFreeCount < pxPool->uxMinimumFreeCount )
+        {
+            pxPool->uxMinimumFreeCount = pxPool->uxFreeCount;
+        }
+
+        return ( void * ) pxBlock;
+    }
+/*-----------------------------------------------------------*/
+
+/*
+ * Link a block back into the free list. Interrupts must be masked.
+ */
+    static void prvPushBlock( MemPool_t * pxPool,
+                              void * pvBlock )
+    {
+        MemPoolBlock_t * pxBlock = ( MemPoolBlock_t * ) pvBlock;
+
+        pxBlock->pxNext = pxPool->pxFreeBlocks;
+        pxPool->pxFreeBlocks = pxBlock;
+        pxPool->uxFreeCount++;
+    }
+/*-----------------------------------------------------------*/
+
+    MemPoolHandle_t xMemPoolCreate( void * pvBuffer,
+                                    size_t xBlockSize,
+                                    UBaseType_t uxBlocks )
+    {
+        MemPool_t * pxPool;
+        uint8_t * pucBlock = ( uint8_t * ) pvBuffer;
+        UBaseType_t uxBlock;
+
+        configASSERT( pvBuffer );
+        configASSERT( xBlockSize >= sizeof( MemPoolBlock_t ) );
+        configASSERT( uxBlocks > 0 );
+
+        pxPool = ( MemPool_t * ) pvPortMalloc( sizeof( MemPool_t ) );
+
+        if( pxPool != NULL )
+        {
+            pxPool->xBlocksFree = xSemaphoreCreateCounting( uxBlocks, uxBlocks );
+
+            if( pxPool->xBlocksFree != NULL )
+            {
+                pxPool->pxFreeBlocks = NULL;
+                pxPool->uxBlocks = uxBlocks;
+                pxPool->uxFreeCount = 0;
+
+                /* Link the blocks in order, so the first taken is the first in the buffer. */
+                pucBlock += xBlockSize * uxBlocks;
+
+                for( uxBlock = 0; uxBlock < uxBlocks; uxBlock++ )
+                {
+                    pucBlock -= xBlockSize;
+                    prvPushBlock( pxPool, pucBlock );
+                }
+
+                pxPool->uxMinimumFreeCount = uxBlocks;
+            }
+            else
+            {
+                vPortFree( pxPool );
+                pxPool = NULL;
+            }
+        }
+
+        return ( MemPoolHandle_t ) pxPool;
+    }
+/*-----------------------------------------------------------*/
+
+    void * pvMemPoolTake( MemPoolHandle_t xPool,
+                          TickType_t xTicksToWait )
+    {
+        MemPool_t * pxPool = ( MemPool_t * ) xPool;
+        void * pvBlock = NULL;
+
+        configASSERT( pxPool );
+
+        if( xSemaphoreTake( pxPool->xBlocksFree, xTicksToWait ) == pdPASS )
+        {
+            taskENTER_CRITICAL();
+            {
+                pvBlock = prvPopBlock( pxPool );
+            }
+            taskEXIT_CRITICAL();
+        }
+
+        return pvBlock;
+    }
+/*-----------------------------------------------------------*/
+
+    void * pvMemPoolTakeFromISR( MemPoolHandle_t xPool )
+    {
+        MemPool_t * pxPool = ( MemPool_t * ) xPool;
+        void * pvBlock = NULL;
+        UBaseType_t uxSavedInterruptStatus;
+
+        configASSERT( pxPool );
+
+        /* Taking a block never unblocks a task, so there is nothing to yield for. */
+        if( xSemaphoreTakeFromISR( pxPool->xBlocksFree, NULL ) == pdPASS )
+        {
+            uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+            {
+                pvBlock = prvPopBlock( pxPool );
+            }
+            taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+        }
+
+        return pvBlock;
+    }
+/*-----------------------------------------------------------*/
+
+    void vMemPoolGive( MemPoolHandle_t xPool,
+                       void * pvBlock )
+    {
+        MemPool_t * pxPool = ( MemPool_t * ) xPool;
+
+        configASSERT( pxPool );
+        configASSERT( pvBlock );
+
+        /* Link the block before counting it, so a task woken by the
+         * semaphore always finds a block in the list. */
+        taskENTER_CRITICAL();
+        {
+            prvPushBlock( pxPool, pvBlock );
+        }
+        taskEXIT_CRITICAL();
+
+        ( void ) xSemaphoreGive( pxPool->xBlocksFree );
+    }
+/*-----------------------------------------------------------*/
+
+    void vMemPoolGiveFromISR( MemPoolHandle_t xPool,
+                              void * pvBlock,
+                              BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        MemPool_t * pxPool = ( MemPool_t * ) xPool;
+        UBaseType_t uxSavedInterruptStatus;
+
+        configASSERT( pxPool );
+        configASSERT( pvBlock );
+
+        uxSavedInterruptStatus = taskENTER_CRITICAL_FROM_ISR();
+        {
+            prvPushBlock( pxPool, pvBlock );
+        }
+        taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+        ( void ) xSemaphoreGiveFromISR( pxPool->xBlocksFree, pxHigherPriorityTaskWoken );
+    }
+/*-----------------------------------------------------------*/
+
+    UBaseType_t uxMemPoolGetFreeCount( MemPoolHandle_t xPool )
+    {
+        configASSERT( xPool );
+
+        return uxSemaphoreGetCount( ( ( MemPool_t * ) xPool )->xBlocksFree );
+    }
+/*-----------------------------------------------------------*/
+
+    UBaseType_t uxMemPoolGetHighWaterMark( MemPoolHandle_t xPool )
+    {
+        MemPool_t * pxPool = ( MemPool_t * ) xPool;
+
+        configASSERT( pxPool );
+
+        return pxPool->uxBlocks - pxPool->uxMinimumFreeCount;
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configUSE_COUNTING_SEMAPHORES == 1 ) */
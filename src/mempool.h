@@ -0,0 +1,163 @@
+/*
+ * FreeRTOS Kernel V11.1.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+#ifndef MEMPOOL_H
+#define MEMPOOL_H
+
+#ifndef INC_ARDUINO_FREERTOS_H
+    #error "include Arduino_FreeRTOS.h" must appear in source files before "include mempool.h"
+#endif
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * A memory pool is a fixed number of blocks of one size, taken from an array
+ * provided by the application. Taking and giving a block takes a constant
+ * time, and can be done from a task or an interrupt, so an interrupt can fill
+ * a block and pass a pointer to it through a queue, rather than copying the
+ * data. A task can wait for a block to be given back when the pool is empty.
+ *
+ * Free blocks are linked through their first bytes, so there is no overhead
+ * for each block, but blocks must be at least sizeof( void * ) bytes.
+ */
+
+/**
+ * mempool.h
+ *
+ * Type by which memory pools are referenced.
+ */
+struct MemPoolDef_t;
+typedef struct MemPoolDef_t * MemPoolHandle_t;
+
+/**
+ * mempool.h
+ * @code{c}
+ * MemPoolHandle_t xMemPoolCreate( void * pvBuffer, size_t xBlockSize, UBaseType_t uxBlocks );
+ * @endcode
+ *
+ * Create a memory pool of uxBlocks blocks of xBlockSize bytes, from pvBuffer,
+ * which must be at least xBlockSize * uxBlocks bytes. The pool itself is
+ * allocated with pvPortMalloc().
+ *
+ * @return The handle of the pool, or NULL if there wasn't enough heap.
+ *
+ * Example usage:
+ * @code{c}
+ * static uint8_t ucSamples[ 4 ][ 32 ];
+ * MemPoolHandle_t xSamplePool = xMemPoolCreate( ucSamples, sizeof( ucSamples[ 0 ] ), 4 );
+ * @endcode
+ */
+MemPoolHandle_t xMemPoolCreate( void * pvBuffer,
+                                size_t xBlockSize,
+                                UBaseType_t uxBlocks ) PRIVILEGED_FUNCTION;
+
+/**
+ * mempool.h
+ * @code{c}
+ * void * pvMemPoolTake( MemPoolHandle_t xPool, TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Take a block from the pool, waiting up to xTicksToWait for a block to be
+ * given back if the pool is empty.
+ *
+ * @return The block, or NULL if none was available in time.
+ */
+void * pvMemPoolTake( MemPoolHandle_t xPool,
+                      TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * mempool.h
+ * @code{c}
+ * void * pvMemPoolTakeFromISR( MemPoolHandle_t xPool );
+ * @endcode
+ *
+ * Take a block from the pool in an interrupt.
+ *
+ * @return The block, or NULL if the pool is empty.
+ */
+void * pvMemPoolTakeFromISR( MemPoolHandle_t xPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * mempool.h
+ * @code{c}
+ * void vMemPoolGive( MemPoolHandle_t xPool, void * pvBlock );
+ * @endcode
+ *
+ * Give a block back to the pool it was taken from, unblocking a task waiting
+ * in pvMemPoolTake().
+ */
+void vMemPoolGive( MemPoolHandle_t xPool,
+                   void * pvBlock ) PRIVILEGED_FUNCTION;
+
+/**
+ * mempool.h
+ * @code{c}
+ * void vMemPoolGiveFromISR( MemPoolHandle_t xPool, void * pvBlock, BaseType_t * pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Give a block back to the pool in an interrupt. *pxHigherPriorityTaskWoken
+ * is set to pdTRUE if a task waiting for a block should run now, in which case
+ * the interrupt should call portYIELD_FROM_ISR().
+ */
+void vMemPoolGiveFromISR( MemPoolHandle_t xPool,
+                          void * pvBlock,
+                          BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * mempool.h
+ * @code{c}
+ * UBaseType_t uxMemPoolGetFreeCount( MemPoolHandle_t xPool );
+ * @endcode
+ *
+ * @return The number of blocks in the pool that are free now.
+ */
+UBaseType_t uxMemPoolGetFreeCount( MemPoolHandle_t xPool ) PRIVILEGED_FUNCTION;
+
+/**
+ * mempool.h
+ * @code{c}
+ * UBaseType_t uxMemPoolGetHighWaterMark( MemPoolHandle_t xPool );
+ * @endcode
+ *
+ * @return The largest number of blocks that have been taken at the same
+ * time, since the pool was created. If this is the size of the pool, callers
+ * may have had to wait for a block.
+ */
+UBaseType_t uxMemPoolGetHighWaterMark( MemPoolHandle_t xPool ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* MEMPOOL_H */
@@ -44,13 +44,240 @@
 /* Start tasks with interrupts enabled. */
 #define portFLAGS_INT_ENABLED    ( ( StackType_t ) 0x80 )
 
+/* Frame tags pushed last by portSAVE_CONTEXT() and portSAVE_VOLUNTARY_CONTEXT(). */
+#define portFULL_FRAME_TAG          ( ( StackType_t ) 0x00 )
+#define portVOLUNTARY_FRAME_TAG     ( ( StackType_t ) 0x01 )
+
 #if defined( portUSE_WDTO )
     #define portSCHEDULER_ISR    WDT_vect
 
+    #if ( portCALIBRATE_WDTO == 1 ) && !defined( TCCR0B )
+        #undef portCALIBRATE_WDTO
+        #define portCALIBRATE_WDTO  0   /* the ATmega8 style Timer0 can't be used to calibrate the WDT */
+    #endif
+
+#elif defined( portUSE_TIMER0_MILLIS )
+    #if !defined( OCIE0A )
+        #error "portUSE_TIMER0_MILLIS requires a Timer0 with compare match A."
+    #endif
+    #define portSCHEDULER_ISR       TIMER0_COMPA_vect
+    #if ( configUSE_TICKLESS_IDLE == 1 )
+        #error "configUSE_TICKLESS_IDLE can't stretch the shared Arduino Timer0 Tick. Use the WDT or another Timer."
+    #endif
+
+#elif defined( portUSE_TIMER1 )
+    #define portSCHEDULER_ISR       TIMER1_COMPA_vect
+    #define portTIMER_TCCRA         TCCR1A
+    #define portTIMER_TCCRB         TCCR1B
+    #define portTIMER_TCNT          TCNT1
+    #define portTIMER_OCRA          OCR1A
+    #define portTIMER_TIMSK         TIMSK1
+    #define portTIMER_TIFR          TIFR1
+    #define portTIMER_CTC_A         0x00
+    #define portTIMER_CTC_B         _BV( WGM12 )
+    #define portTIMER_OCIEA         _BV( OCIE1A )
+    #define portTIMER_OCFA          _BV( OCF1A )
+    #define portTIMER_OCRB          OCR1B
+    #define portTIMER_OCIEB         _BV( OCIE1B )
+    #define portTIMER_OCFB          _BV( OCF1B )
+    #define portDELAY_US_ISR        TIMER1_COMPB_vect
+    #define portTIMER_16_BIT
+
+#elif defined( portUSE_TIMER2 ) || defined( portUSE_TIMER2_ASYNC )
+    #if !defined( TCCR2A ) || !defined( OCIE2A )
+        #error "portUSE_TIMER2 requires an 8-bit Timer2 with TCCR2A and OCR2A."
+    #endif
+    #if defined( portUSE_TIMER2_ASYNC )
+        #if !defined( AS2 )
+            #error "portUSE_TIMER2_ASYNC requires a Timer2 with an asynchronous (TOSC) clock."
+        #endif
+        #define portTIMER_ASYNC
+        #define portTIMER_CLOCK_HZ  32768UL     /* watch crystal on the TOSC1 and TOSC2 pins */
+    #endif
+    #define portSCHEDULER_ISR       TIMER2_COMPA_vect
+    #define portTIMER_TCCRA         TCCR2A
+    #define portTIMER_TCCRB         TCCR2B
+    #define portTIMER_TCNT          TCNT2
+    #define portTIMER_OCRA          OCR2A
+    #define portTIMER_TIMSK         TIMSK2
+    #define portTIMER_TIFR          TIFR2
+    #define portTIMER_CTC_A         _BV( WGM21 )
+    #define portTIMER_CTC_B         0x00
+    #define portTIMER_OCIEA         _BV( OCIE2A )
+    #define portTIMER_OCFA          _BV( OCF2A )
+    #define portTIMER_OCRB          OCR2B
+    #define portTIMER_OCIEB         _BV( OCIE2B )
+    #define portTIMER_OCFB          _BV( OCF2B )
+    #define portDELAY_US_ISR        TIMER2_COMPB_vect
+    #define portTIMER_8_BIT
+
+#elif defined( portUSE_TIMER3 )
+    #if !defined( TCCR3B )
+        #error "portUSE_TIMER3 requires a device with Timer3."
+    #endif
+    #define portSCHEDULER_ISR       TIMER3_COMPA_vect
+    #define portTIMER_TCCRA         TCCR3A
+    #define portTIMER_TCCRB         TCCR3B
+    #define portTIMER_TCNT          TCNT3
+    #define portTIMER_OCRA          OCR3A
+    #define portTIMER_TIMSK         TIMSK3
+    #define portTIMER_TIFR          TIFR3
+    #define portTIMER_CTC_A         0x00
+    #define portTIMER_CTC_B         _BV( WGM32 )
+    #define portTIMER_OCIEA         _BV( OCIE3A )
+    #define portTIMER_OCFA          _BV( OCF3A )
+    #define portTIMER_OCRB          OCR3B
+    #define portTIMER_OCIEB         _BV( OCIE3B )
+    #define portTIMER_OCFB          _BV( OCF3B )
+    #define portDELAY_US_ISR        TIMER3_COMPB_vect
+    #define portTIMER_16_BIT
+
+#elif defined( portUSE_TIMER4 )
+    #if !defined( TCCR4B ) || !defined( WGM42 )
+        #error "portUSE_TIMER4 requires a device with a 16-bit Timer4, not the ATmega32U4 high speed Timer4."
+    #endif
+    #define portSCHEDULER_ISR       TIMER4_COMPA_vect
+    #define portTIMER_TCCRA         TCCR4A
+    #define portTIMER_TCCRB         TCCR4B
+    #define portTIMER_TCNT          TCNT4
+    #define portTIMER_OCRA          OCR4A
+    #define portTIMER_TIMSK         TIMSK4
+    #define portTIMER_TIFR          TIFR4
+    #define portTIMER_CTC_A         0x00
+    #define portTIMER_CTC_B         _BV( WGM42 )
+    #define portTIMER_OCIEA         _BV( OCIE4A )
+    #define portTIMER_OCFA          _BV( OCF4A )
+    #define portTIMER_OCRB          OCR4B
+    #define portTIMER_OCIEB         _BV( OCIE4B )
+    #define portTIMER_OCFB          _BV( OCF4B )
+    #define portDELAY_US_ISR        TIMER4_COMPB_vect
+    #define portTIMER_16_BIT
+
+#elif defined( portUSE_TIMER5 )
+    #if !defined( TCCR5B )
+        #error "portUSE_TIMER5 requires a device with Timer5."
+    #endif
+    #define portSCHEDULER_ISR       TIMER5_COMPA_vect
+    #define portTIMER_TCCRA         TCCR5A
+    #define portTIMER_TCCRB         TCCR5B
+    #define portTIMER_TCNT          TCNT5
+    #define portTIMER_OCRA          OCR5A
+    #define portTIMER_TIMSK         TIMSK5
+    #define portTIMER_TIFR          TIFR5
+    #define portTIMER_CTC_A         0x00
+    #define portTIMER_CTC_B         _BV( WGM52 )
+    #define portTIMER_OCIEA         _BV( OCIE5A )
+    #define portTIMER_OCFA          _BV( OCF5A )
+    #define portTIMER_OCRB          OCR5B
+    #define portTIMER_OCIEB         _BV( OCIE5B )
+    #define portTIMER_OCFB          _BV( OCF5B )
+    #define portDELAY_US_ISR        TIMER5_COMPB_vect
+    #define portTIMER_16_BIT
+
 #else
     #warning "The user must define a Timer to be used for the Scheduler."
 #endif
 
+/*
+ * Select the smallest prescaler that divides the Timer clock exactly into
+ * configTICK_RATE_HZ, with a compare value that fits the Timer. Smallest is best,
+ * as it gives the finest resolution for the TCNT reading.
+ *
+ * With tickless idle the compare value is stretched to cover several Ticks, so
+ * the largest prescaler is selected instead, for the longest possible sleep.
+ *
+ * The Clock Select bits CS2:0 are the same for Timer1, Timer3, Timer4 and Timer5,
+ * but Timer2 has two extra prescaler options (32 and 128).
+ */
+#if defined( portTIMER_16_BIT ) || defined( portTIMER_8_BIT )
+
+    #if !defined( portTIMER_CLOCK_HZ )
+        #define portTIMER_CLOCK_HZ      F_CPU
+    #endif
+
+    #if defined( portTIMER_16_BIT )
+        #define portTIMER_MAX_COUNT     65536UL
+        #define portTIMER_CS_64         0x03
+        #define portTIMER_CS_256        0x04
+        #define portTIMER_CS_1024       0x05
+    #else
+        #define portTIMER_MAX_COUNT     256UL
+        #define portTIMER_CS_32         0x03
+        #define portTIMER_CS_64         0x04
+        #define portTIMER_CS_128        0x05
+        #define portTIMER_CS_256        0x06
+        #define portTIMER_CS_1024       0x07
+    #endif
+
+    #define portTIMER_FITS( prescaler )     ( ( ( portTIMER_CLOCK_HZ ) % ( ( prescaler ) * ( configTICK_RATE_HZ ) ) == 0 ) && \
+                                              ( ( portTIMER_CLOCK_HZ ) / ( ( prescaler ) * ( configTICK_RATE_HZ ) ) <= portTIMER_MAX_COUNT ) )
+
+    #if ( configUSE_TICKLESS_IDLE == 1 )
+        #if portTIMER_FITS( 1024UL )
+            #define portTIMER_PRESCALER     1024UL
+            #define portTIMER_CS            portTIMER_CS_1024
+        #elif portTIMER_FITS( 256UL )
+            #define portTIMER_PRESCALER     256UL
+            #define portTIMER_CS            portTIMER_CS_256
+        #elif defined( portTIMER_8_BIT ) && portTIMER_FITS( 128UL )
+            #define portTIMER_PRESCALER     128UL
+            #define portTIMER_CS            portTIMER_CS_128
+        #elif portTIMER_FITS( 64UL )
+            #define portTIMER_PRESCALER     64UL
+            #define portTIMER_CS            portTIMER_CS_64
+        #elif defined( portTIMER_8_BIT ) && portTIMER_FITS( 32UL )
+            #define portTIMER_PRESCALER     32UL
+            #define portTIMER_CS            portTIMER_CS_32
+        #elif portTIMER_FITS( 8UL )
+            #define portTIMER_PRESCALER     8UL
+            #define portTIMER_CS            0x02
+        #elif portTIMER_FITS( 1UL )
+            #define portTIMER_PRESCALER     1UL
+            #define portTIMER_CS            0x01
+        #endif
+    #else
+        #if portTIMER_FITS( 1UL )
+            #define portTIMER_PRESCALER     1UL
+            #define portTIMER_CS            0x01
+        #elif portTIMER_FITS( 8UL )
+            #define portTIMER_PRESCALER     8UL
+            #define portTIMER_CS            0x02
+        #elif defined( portTIMER_8_BIT ) && portTIMER_FITS( 32UL )
+            #define portTIMER_PRESCALER     32UL
+            #define portTIMER_CS            portTIMER_CS_32
+        #elif portTIMER_FITS( 64UL )
+            #define portTIMER_PRESCALER     64UL
+            #define portTIMER_CS            portTIMER_CS_64
+        #elif defined( portTIMER_8_BIT ) && portTIMER_FITS( 128UL )
+            #define portTIMER_PRESCALER     128UL
+            #define portTIMER_CS            portTIMER_CS_128
+        #elif portTIMER_FITS( 256UL )
+            #define portTIMER_PRESCALER     256UL
+            #define portTIMER_CS            portTIMER_CS_256
+        #elif portTIMER_FITS( 1024UL )
+            #define portTIMER_PRESCALER     1024UL
+            #define portTIMER_CS            portTIMER_CS_1024
+        #endif
+    #endif
+
+    #if !defined( portTIMER_PRESCALER )
+        #error "configTICK_RATE_HZ can't be generated exactly from the Timer clock by the selected Timer. Choose another rate or Timer."
+    #endif
+
+    #define portTIMER_COUNTS_PER_TICK   ( ( portTIMER_CLOCK_HZ ) / ( portTIMER_PRESCALER * ( configTICK_RATE_HZ ) ) )
+    #define portTIMER_COMPARE           ( portTIMER_COUNTS_PER_TICK - 1 )
+
+#endif /* defined( portTIMER_16_BIT ) || defined( portTIMER_8_BIT ) */
+
+#if ( configUSE_PORT_DELAY_US == 1 )
+    #if !defined( portDELAY_US_ISR ) || defined( portTIMER_ASYNC )
+        #error "configUSE_PORT_DELAY_US uses compare match B of the tick Timer, so requires portUSE_TIMER1 to portUSE_TIMER5."
+    #endif
+    #if ( INCLUDE_vTaskSuspend != 1 ) || ( INCLUDE_xTaskResumeFromISR != 1 ) || ( INCLUDE_xTaskGetCurrentTaskHandle != 1 )
+        #error "configUSE_PORT_DELAY_US requires INCLUDE_vTaskSuspend, INCLUDE_xTaskResumeFromISR and INCLUDE_xTaskGetCurrentTaskHandle."
+    #endif
+#endif
+
 /*-----------------------------------------------------------*/
 
 /* We require the address of the pxCurrentTCB variable, but don't want to know
@@ -186,9 +413,35 @@ void wdt_interrupt_reset_enable (const uint8_t value)
 }
 #endif /* if defined( portUSE_WDTO ) */
 
+/*-----------------------------------------------------------*/
+
+#if configUSE_PORT_OPTIMISED_TASK_SELECTION == 1
+
+/* Bit mask for each priority, used to set and clear the ready priorities bit map. */
+const uint8_t ucPortPriorityBitMask[ 8 ] PROGMEM =
+{
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80
+};
+
+/* Index of the most significant set bit in a nibble. Entry 0 is never used,
+ * as the Idle task is always ready. */
+const uint8_t ucPortHighestBitInNibble[ 16 ] PROGMEM =
+{
+    0, 0, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3
+};
+
+#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+
 /*-----------------------------------------------------------*/
 /* actual number of ticks per second, after configuration. Not for RTC, which has 1 tick/second. */
-TickType_t portTickRateHz;
+volatile TickType_t portTickRateHz = configTICK_RATE_HZ;
+
+/* actual Tick period in microseconds, measured for the WDT if calibration is enabled. */
+#if defined( portUSE_WDTO )
+volatile uint32_t portTickPeriodUs = (uint32_t)portTICK_PERIOD_MS * 1000UL;
+#else
+volatile uint32_t portTickPeriodUs = 1000000UL / configTICK_RATE_HZ;
+#endif
 
 /* remaining ticks in each second, decremented to enable the system_tick. Not for RTC, which has 1 tick/second. */
 volatile TickType_t ticksRemainingInSec;
@@ -219,6 +472,10 @@ volatile TickType_t ticksRemainingInSec;
  *
  * The interrupts will have been disabled during the call to portSAVE_CONTEXT()
  * so we need not worry about reading/writing to the stack pointer.
+ *
+ * The last byte pushed is a frame tag (0x00 here), which tells
+ * portRESTORE_CONTEXT() which frame layout to pop. So every preempted task
+ * stack holds one Byte more than a frame without the tag.
  */
 #if defined(__AVR_3_BYTE_PC__) && defined(__AVR_HAVE_RAMPZ__)
 /* 3-Byte PC Save  with RAMPZ */
@@ -263,6 +520,7 @@ volatile TickType_t ticksRemainingInSec;
                                 "push   r29                                     \n\t"   \
                                 "push   r30                                     \n\t"   \
                                 "push   r31                                     \n\t"   \
+                                "push   __zero_reg__                            \n\t"   \
                                 "lds    r26, pxCurrentTCB                       \n\t"   \
                                 "lds    r27, pxCurrentTCB + 1                   \n\t"   \
                                 "in     __tmp_reg__, __SP_L__                   \n\t"   \
@@ -311,6 +569,7 @@ volatile TickType_t ticksRemainingInSec;
                                 "push   r29                                     \n\t"   \
                                 "push   r30                                     \n\t"   \
                                 "push   r31                                     \n\t"   \
+                                "push   __zero_reg__                            \n\t"   \
                                 "lds    r26, pxCurrentTCB                       \n\t"   \
                                 "lds    r27, pxCurrentTCB + 1                   \n\t"   \
                                 "in     __tmp_reg__, __SP_L__                   \n\t"   \
@@ -357,6 +616,124 @@ volatile TickType_t ticksRemainingInSec;
                                 "push   r29                                     \n\t"   \
                                 "push   r30                                     \n\t"   \
                                 "push   r31                                     \n\t"   \
+                                "push   __zero_reg__                            \n\t"   \
+                                "lds    r26, pxCurrentTCB                       \n\t"   \
+                                "lds    r27, pxCurrentTCB + 1                   \n\t"   \
+                                "in     __tmp_reg__, __SP_L__                   \n\t"   \
+                                "st     x+, __tmp_reg__                         \n\t"   \
+                                "in     __tmp_reg__, __SP_H__                   \n\t"   \
+                                "st     x+, __tmp_reg__                         \n\t"   \
+                             );
+#endif /* if defined( __AVR_3_BYTE_PC__ ) && defined( __AVR_HAVE_RAMPZ__ ) */
+
+/*
+ * Macro to save only the call-saved registers, for use by vPortYield().
+ *
+ * A voluntary yield is a normal function call, so the compiler has already
+ * discarded the call-clobbered registers r0, r18 - r27, r30 and r31, and r1
+ * is zero. So only SREG, RAMPZ, EIND, r2 - r17 and r28 - r29 are saved,
+ * followed by the frame tag 0x01. This is 14 Bytes less than the tagged full
+ * frame (13 Bytes less than a full frame without the tag) on every blocked
+ * task stack.
+ */
+#if defined(__AVR_3_BYTE_PC__) && defined(__AVR_HAVE_RAMPZ__)
+/* 3-Byte PC Save  with RAMPZ */
+#define portSAVE_VOLUNTARY_CONTEXT()                                                    \
+        __asm__ __volatile__ (  "in     __tmp_reg__, __SREG__                   \n\t"   \
+                                "cli                                            \n\t"   \
+                                "push   __tmp_reg__                             \n\t"   \
+                                "in     __tmp_reg__, 0x3B                       \n\t"   \
+                                "push   __tmp_reg__                             \n\t"   \
+                                "in     __tmp_reg__, 0x3C                       \n\t"   \
+                                "push   __tmp_reg__                             \n\t"   \
+                                "push   r2                                      \n\t"   \
+                                "push   r3                                      \n\t"   \
+                                "push   r4                                      \n\t"   \
+                                "push   r5                                      \n\t"   \
+                                "push   r6                                      \n\t"   \
+                                "push   r7                                      \n\t"   \
+                                "push   r8                                      \n\t"   \
+                                "push   r9                                      \n\t"   \
+                                "push   r10                                     \n\t"   \
+                                "push   r11                                     \n\t"   \
+                                "push   r12                                     \n\t"   \
+                                "push   r13                                     \n\t"   \
+                                "push   r14                                     \n\t"   \
+                                "push   r15                                     \n\t"   \
+                                "push   r16                                     \n\t"   \
+                                "push   r17                                     \n\t"   \
+                                "push   r28                                     \n\t"   \
+                                "push   r29                                     \n\t"   \
+                                "ldi    r18, 0x01                               \n\t"   \
+                                "push   r18                                     \n\t"   \
+                                "lds    r26, pxCurrentTCB                       \n\t"   \
+                                "lds    r27, pxCurrentTCB + 1                   \n\t"   \
+                                "in     __tmp_reg__, __SP_L__                   \n\t"   \
+                                "st     x+, __tmp_reg__                         \n\t"   \
+                                "in     __tmp_reg__, __SP_H__                   \n\t"   \
+                                "st     x+, __tmp_reg__                         \n\t"   \
+                             );
+#elif defined(__AVR_HAVE_RAMPZ__)
+/* 2-Byte PC Save  with RAMPZ */
+#define portSAVE_VOLUNTARY_CONTEXT()                                                    \
+        __asm__ __volatile__ (  "in     __tmp_reg__, __SREG__                   \n\t"   \
+                                "cli                                            \n\t"   \
+                                "push   __tmp_reg__                             \n\t"   \
+                                "in     __tmp_reg__, 0x3B                       \n\t"   \
+                                "push   __tmp_reg__                             \n\t"   \
+                                "push   r2                                      \n\t"   \
+                                "push   r3                                      \n\t"   \
+                                "push   r4                                      \n\t"   \
+                                "push   r5                                      \n\t"   \
+                                "push   r6                                      \n\t"   \
+                                "push   r7                                      \n\t"   \
+                                "push   r8                                      \n\t"   \
+                                "push   r9                                      \n\t"   \
+                                "push   r10                                     \n\t"   \
+                                "push   r11                                     \n\t"   \
+                                "push   r12                                     \n\t"   \
+                                "push   r13                                     \n\t"   \
+                                "push   r14                                     \n\t"   \
+                                "push   r15                                     \n\t"   \
+                                "push   r16                                     \n\t"   \
+                                "push   r17                                     \n\t"   \
+                                "push   r28                                     \n\t"   \
+                                "push   r29                                     \n\t"   \
+                                "ldi    r18, 0x01                               \n\t"   \
+                                "push   r18                                     \n\t"   \
+                                "lds    r26, pxCurrentTCB                       \n\t"   \
+                                "lds    r27, pxCurrentTCB + 1                   \n\t"   \
+                                "in     __tmp_reg__, __SP_L__                   \n\t"   \
+                                "st     x+, __tmp_reg__                         \n\t"   \
+                                "in     __tmp_reg__, __SP_H__                   \n\t"   \
+                                "st     x+, __tmp_reg__                         \n\t"   \
+                             );
+#else /* if defined( __AVR_3_BYTE_PC__ ) && defined( __AVR_HAVE_RAMPZ__ ) */
+/* 2-Byte PC Save */
+#define portSAVE_VOLUNTARY_CONTEXT()                                                    \
+        __asm__ __volatile__ (  "in     __tmp_reg__, __SREG__                   \n\t"   \
+                                "cli                                            \n\t"   \
+                                "push   __tmp_reg__                             \n\t"   \
+                                "push   r2                                      \n\t"   \
+                                "push   r3                                      \n\t"   \
+                                "push   r4                                      \n\t"   \
+                                "push   r5                                      \n\t"   \
+                                "push   r6                                      \n\t"   \
+                                "push   r7                                      \n\t"   \
+                                "push   r8                                      \n\t"   \
+                                "push   r9                                      \n\t"   \
+                                "push   r10                                     \n\t"   \
+                                "push   r11                                     \n\t"   \
+                                "push   r12                                     \n\t"   \
+                                "push   r13                                     \n\t"   \
+                                "push   r14                                     \n\t"   \
+                                "push   r15                                     \n\t"   \
+                                "push   r16                                     \n\t"   \
+                                "push   r17                                     \n\t"   \
+                                "push   r28                                     \n\t"   \
+                                "push   r29                                     \n\t"   \
+                                "ldi    r18, 0x01                               \n\t"   \
+                                "push   r18                                     \n\t"   \
                                 "lds    r26, pxCurrentTCB                       \n\t"   \
                                 "lds    r27, pxCurrentTCB + 1                   \n\t"   \
                                 "in     __tmp_reg__, __SP_L__                   \n\t"   \
@@ -367,8 +744,12 @@ volatile TickType_t ticksRemainingInSec;
 #endif /* if defined( __AVR_3_BYTE_PC__ ) && defined( __AVR_HAVE_RAMPZ__ ) */
 
 /*
- * Opposite to portSAVE_CONTEXT().  Interrupts will have been disabled during
- * the context save so we can write to the stack pointer.
+ * Opposite to portSAVE_CONTEXT() and portSAVE_VOLUNTARY_CONTEXT(). Interrupts
+ * will have been disabled during the context save so we can write to the stack
+ * pointer. The frame tag selects which layout to pop.
+ *
+ * Restoring a voluntary frame leaves the call-clobbered registers undefined, and
+ * sets r1 to zero as the compiler expects.
  */
 #if defined(__AVR_3_BYTE_PC__) && defined(__AVR_HAVE_RAMPZ__)
 /* 3-Byte PC Restore with RAMPZ */
@@ -379,6 +760,9 @@ volatile TickType_t ticksRemainingInSec;
                                 "out    __SP_L__, r28                           \n\t"   \
                                 "ld     r29, x+                                 \n\t"   \
                                 "out    __SP_H__, r29                           \n\t"   \
+                                "pop    __tmp_reg__                             \n\t"   \
+                                "sbrc   __tmp_reg__, 0                          \n\t"   \
+                                "rjmp   1f                                      \n\t"   \
                                 "pop    r31                                     \n\t"   \
                                 "pop    r30                                     \n\t"   \
                                 "pop    r29                                     \n\t"   \
@@ -417,6 +801,34 @@ volatile TickType_t ticksRemainingInSec;
                                 "pop    __tmp_reg__                             \n\t"   \
                                 "out    __SREG__, __tmp_reg__                   \n\t"   \
                                 "pop    __tmp_reg__                             \n\t"   \
+                                "rjmp   2f                                      \n\t"   \
+                                "1:                                             \n\t"   \
+                                "pop    r29                                     \n\t"   \
+                                "pop    r28                                     \n\t"   \
+                                "pop    r17                                     \n\t"   \
+                                "pop    r16                                     \n\t"   \
+                                "pop    r15                                     \n\t"   \
+                                "pop    r14                                     \n\t"   \
+                                "pop    r13                                     \n\t"   \
+                                "pop    r12                                     \n\t"   \
+                                "pop    r11                                     \n\t"   \
+                                "pop    r10                                     \n\t"   \
+                                "pop    r9                                      \n\t"   \
+                                "pop    r8                                      \n\t"   \
+                                "pop    r7                                      \n\t"   \
+                                "pop    r6                                      \n\t"   \
+                                "pop    r5                                      \n\t"   \
+                                "pop    r4                                      \n\t"   \
+                                "pop    r3                                      \n\t"   \
+                                "pop    r2                                      \n\t"   \
+                                "clr    __zero_reg__                            \n\t"   \
+                                "pop    __tmp_reg__                             \n\t"   \
+                                "out    0x3C, __tmp_reg__                       \n\t"   \
+                                "pop    __tmp_reg__                             \n\t"   \
+                                "out    0x3B, __tmp_reg__                       \n\t"   \
+                                "pop    __tmp_reg__                             \n\t"   \
+                                "out    __SREG__, __tmp_reg__                   \n\t"   \
+                                "2:                                             \n\t"   \
                              );
 #elif defined(__AVR_HAVE_RAMPZ__)
 /* 2-Byte PC Restore with RAMPZ */
@@ -427,6 +839,9 @@ volatile TickType_t ticksRemainingInSec;
                                 "out    __SP_L__, r28                           \n\t"   \
                                 "ld     r29, x+                                 \n\t"   \
                                 "out    __SP_H__, r29                           \n\t"   \
+                                "pop    __tmp_reg__                             \n\t"   \
+                                "sbrc   __tmp_reg__, 0                          \n\t"   \
+                                "rjmp   1f                                      \n\t"   \
                                 "pop    r31                                     \n\t"   \
                                 "pop    r30                                     \n\t"   \
                                 "pop    r29                                     \n\t"   \
@@ -463,6 +878,32 @@ volatile TickType_t ticksRemainingInSec;
                                 "pop    __tmp_reg__                             \n\t"   \
                                 "out    __SREG__, __tmp_reg__                   \n\t"   \
                                 "pop    __tmp_reg__                             \n\t"   \
+                                "rjmp   2f                                      \n\t"   \
+                                "1:                                             \n\t"   \
+                                "pop    r29                                     \n\t"   \
+                                "pop    r28                                     \n\t"   \
+                                "pop    r17                                     \n\t"   \
+                                "pop    r16                                     \n\t"   \
+                                "pop    r15                                     \n\t"   \
+                                "pop    r14                                     \n\t"   \
+                                "pop    r13                                     \n\t"   \
+                                "pop    r12                                     \n\t"   \
+                                "pop    r11                                     \n\t"   \
+                                "pop    r10                                     \n\t"   \
+                                "pop    r9                                      \n\t"   \
+                                "pop    r8                                      \n\t"   \
+                                "pop    r7                                      \n\t"   \
+                                "pop    r6                                      \n\t"   \
+                                "pop    r5                                      \n\t"   \
+                                "pop    r4                                      \n\t"   \
+                                "pop    r3                                      \n\t"   \
+                                "pop    r2                                      \n\t"   \
+                                "clr    __zero_reg__                            \n\t"   \
+                                "pop    __tmp_reg__                             \n\t"   \
+                                "out    0x3B, __tmp_reg__                       \n\t"   \
+                                "pop    __tmp_reg__                             \n\t"   \
+                                "out    __SREG__, __tmp_reg__                   \n\t"   \
+                                "2:                                             \n\t"   \
                              );
 #else /* if defined( __AVR_3_BYTE_PC__ ) && defined( __AVR_HAVE_RAMPZ__ ) */
 /* 2-Byte PC Restore */
@@ -473,6 +914,9 @@ volatile TickType_t ticksRemainingInSec;
                                 "out    __SP_L__, r28                           \n\t"   \
                                 "ld     r29, x+                                 \n\t"   \
                                 "out    __SP_H__, r29                           \n\t"   \
+                                "pop    __tmp_reg__                             \n\t"   \
+                                "sbrc   __tmp_reg__, 0                          \n\t"   \
+                                "rjmp   1f                                      \n\t"   \
                                 "pop    r31                                     \n\t"   \
                                 "pop    r30                                     \n\t"   \
                                 "pop    r29                                     \n\t"   \
@@ -507,30 +951,197 @@ volatile TickType_t ticksRemainingInSec;
                                 "pop    __tmp_reg__                             \n\t"   \
                                 "out    __SREG__, __tmp_reg__                   \n\t"   \
                                 "pop    __tmp_reg__                             \n\t"   \
+                                "rjmp   2f                                      \n\t"   \
+                                "1:                                             \n\t"   \
+                                "pop    r29                                     \n\t"   \
+                                "pop    r28                                     \n\t"   \
+                                "pop    r17                                     \n\t"   \
+                                "pop    r16                                     \n\t"   \
+                                "pop    r15                                     \n\t"   \
+                                "pop    r14                                     \n\t"   \
+                                "pop    r13                                     \n\t"   \
+                                "pop    r12                                     \n\t"   \
+                                "pop    r11                                     \n\t"   \
+                                "pop    r10                                     \n\t"   \
+                                "pop    r9                                      \n\t"   \
+                                "pop    r8                                      \n\t"   \
+                                "pop    r7                                      \n\t"   \
+                                "pop    r6                                      \n\t"   \
+                                "pop    r5                                      \n\t"   \
+                                "pop    r4                                      \n\t"   \
+                                "pop    r3                                      \n\t"   \
+                                "pop    r2                                      \n\t"   \
+                                "clr    __zero_reg__                            \n\t"   \
+                                "pop    __tmp_reg__                             \n\t"   \
+                                "out    __SREG__, __tmp_reg__                   \n\t"   \
+                                "2:                                             \n\t"   \
                              );
 #endif /* if defined( __AVR_3_BYTE_PC__ ) && defined( __AVR_HAVE_RAMPZ__ ) */
-/*-----------------------------------------------------------*/
-
-/*
- * Perform hardware setup to enable ticks from relevant Timer.
- */
-void prvSetupTimerInterrupt( void );
-/*-----------------------------------------------------------*/
 
 /*
- * See header file for description.
+ * Macros to save and restore only the call-clobbered registers, for the tick.
+ *
+ * This is the same frame that the compiler builds for a normal ISR calling a
+ * function, so xTaskIncrementTick() can be called without saving the whole
+ * context. The full context is only saved if a context switch is required.
  */
-StackType_t * pxPortInitialiseStack( StackType_t * pxTopOfStack,
-                                     TaskFunction_t pxCode,
-                                     void * pvParameters )
-{
-uint16_t usAddress;
-
-    /* Simulate how the stack would look after a call to vPortYield() generated by
-     * the compiler. */
+#if defined(__AVR_HAVE_RAMPZ__)
+/* Save with RAMPZ */
+#define portSAVE_TICK_CONTEXT()                                                         \
+        __asm__ __volatile__ (  "push   __tmp_reg__                             \n\t"   \
+                                "in     __tmp_reg__, __SREG__                   \n\t"   \
+                                "push   __tmp_reg__                             \n\t"   \
+                                "in     __tmp_reg__, 0x3B                       \n\t"   \
+                                "push   __tmp_reg__                             \n\t"   \
+                                "push   __zero_reg__                            \n\t"   \
+                                "clr    __zero_reg__                            \n\t"   \
+                                "push   r18                                     \n\t"   \
+                                "push   r19                                     \n\t"   \
+                                "push   r20                                     \n\t"   \
+                                "push   r21                                     \n\t"   \
+                                "push   r22                                     \n\t"   \
+                                "push   r23                                     \n\t"   \
+                                "push   r24                                     \n\t"   \
+                                "push   r25                                     \n\t"   \
+                                "push   r26                                     \n\t"   \
+                                "push   r27                                     \n\t"   \
+                                "push   r30                                     \n\t"   \
+                                "push   r31                                     \n\t"   \
+                             );
+#else /* if defined( __AVR_HAVE_RAMPZ__ ) */
+/* Save */
+#define portSAVE_TICK_CONTEXT()                                                         \
+        __asm__ __volatile__ (  "push   __tmp_reg__                             \n\t"   \
+                                "in     __tmp_reg__, __SREG__                   \n\t"   \
+                                "push   __tmp_reg__                             \n\t"   \
+                                "push   __zero_reg__                            \n\t"   \
+                                "clr    __zero_reg__                            \n\t"   \
+                                "push   r18                                     \n\t"   \
+                                "push   r19                                     \n\t"   \
+                                "push   r20                                     \n\t"   \
+                                "push   r21                                     \n\t"   \
+                                "push   r22                                     \n\t"   \
+                                "push   r23                                     \n\t"   \
+                                "push   r24                                     \n\t"   \
+                                "push   r25                                     \n\t"   \
+                                "push   r26                                     \n\t"   \
+                                "push   r27                                     \n\t"   \
+                                "push   r30                                     \n\t"   \
+                                "push   r31                                     \n\t"   \
+                             );
+#endif /* if defined( __AVR_HAVE_RAMPZ__ ) */
 
-    /* The start of the task code will be popped off the stack last, so place
-     * it on first. */
+#if defined(__AVR_HAVE_RAMPZ__)
+/* Restore with RAMPZ */
+#define portRESTORE_TICK_CONTEXT()                                                      \
+        __asm__ __volatile__ (  "pop    r31                                     \n\t"   \
+                                "pop    r30                                     \n\t"   \
+                                "pop    r27                                     \n\t"   \
+                                "pop    r26                                     \n\t"   \
+                                "pop    r25                                     \n\t"   \
+                                "pop    r24                                     \n\t"   \
+                                "pop    r23                                     \n\t"   \
+                                "pop    r22                                     \n\t"   \
+                                "pop    r21                                     \n\t"   \
+                                "pop    r20                                     \n\t"   \
+                                "pop    r19                                     \n\t"   \
+                                "pop    r18                                     \n\t"   \
+                                "pop    __zero_reg__                            \n\t"   \
+                                "pop    __tmp_reg__                             \n\t"   \
+                                "out    0x3B, __tmp_reg__                       \n\t"   \
+                                "pop    __tmp_reg__                             \n\t"   \
+                                "out    __SREG__, __tmp_reg__                   \n\t"   \
+                                "pop    __tmp_reg__                             \n\t"   \
+                             );
+#else /* if defined( __AVR_HAVE_RAMPZ__ ) */
+/* Restore */
+#define portRESTORE_TICK_CONTEXT()                                                      \
+        __asm__ __volatile__ (  "pop    r31                                     \n\t"   \
+                                "pop    r30                                     \n\t"   \
+                                "pop    r27                                     \n\t"   \
+                                "pop    r26                                     \n\t"   \
+                                "pop    r25                                     \n\t"   \
+                                "pop    r24                                     \n\t"   \
+                                "pop    r23                                     \n\t"   \
+                                "pop    r22                                     \n\t"   \
+                                "pop    r21                                     \n\t"   \
+                                "pop    r20                                     \n\t"   \
+                                "pop    r19                                     \n\t"   \
+                                "pop    r18                                     \n\t"   \
+                                "pop    __zero_reg__                            \n\t"   \
+                                "pop    __tmp_reg__                             \n\t"   \
+                                "out    __SREG__, __tmp_reg__                   \n\t"   \
+                                "pop    __tmp_reg__                             \n\t"   \
+                             );
+#endif /* if defined( __AVR_HAVE_RAMPZ__ ) */
+/*-----------------------------------------------------------*/
+
+#if ( configISR_STACK_SIZE > 0 )
+
+/*
+ * The interrupt stack is the RAM below RAMEND, used by main() before the
+ * scheduler started, and left free by the heap in initVariant().
+ */
+#define portISR_STACK_TOP   RAMEND
+
+/* The task stack pointer, while an interrupt is running on the interrupt stack. */
+volatile uint16_t usPortTaskStackPointer;
+
+/* Set once main() has finished with the interrupt stack. */
+volatile uint8_t ucPortISRStackReady = pdFALSE;
+
+/*
+ * Macros to move the stack pointer to the top of the interrupt stack, and
+ * back to the task stack. Interrupts must be disabled, and r26 and r27 free.
+ */
+#define portSWITCH_TO_ISR_STACK()                                                       \
+        __asm__ __volatile__ (  "in     r26, __SP_L__                           \n\t"   \
+                                "in     r27, __SP_H__                           \n\t"   \
+                                "sts    usPortTaskStackPointer, r26             \n\t"   \
+                                "sts    usPortTaskStackPointer + 1, r27         \n\t"   \
+                                "ldi    r26, lo8(%0)                            \n\t"   \
+                                "ldi    r27, hi8(%0)                            \n\t"   \
+                                "out    __SP_L__, r26                           \n\t"   \
+                                "out    __SP_H__, r27                           \n\t"   \
+                                :: "i" ( portISR_STACK_TOP ) : "r26", "r27"             \
+                             );
+
+#define portSWITCH_TO_TASK_STACK()                                                      \
+        __asm__ __volatile__ (  "lds    r26, usPortTaskStackPointer             \n\t"   \
+                                "lds    r27, usPortTaskStackPointer + 1         \n\t"   \
+                                "out    __SP_L__, r26                           \n\t"   \
+                                "out    __SP_H__, r27                           \n\t"   \
+                                ::: "r26", "r27"                                        \
+                             );
+
+#else
+
+#define portSWITCH_TO_ISR_STACK()
+#define portSWITCH_TO_TASK_STACK()
+
+#endif /* configISR_STACK_SIZE > 0 */
+/*-----------------------------------------------------------*/
+
+/*
+ * Perform hardware setup to enable ticks from relevant Timer.
+ */
+void prvSetupTimerInterrupt( void );
+/*-----------------------------------------------------------*/
+
+/*
+ * See header file for description.
+ */
+StackType_t * pxPortInitialiseStack( StackType_t * pxTopOfStack,
+                                     TaskFunction_t pxCode,
+                                     void * pvParameters )
+{
+uint16_t usAddress;
+
+    /* Simulate how the stack would look after a call to vPortYield() generated by
+     * the compiler. */
+
+    /* The start of the task code will be popped off the stack last, so place
+     * it on first. */
     usAddress = ( uint16_t ) pxCode;
     *pxTopOfStack = ( StackType_t ) ( usAddress & ( uint16_t ) 0x00ff );
     pxTopOfStack--;
@@ -599,6 +1210,10 @@ uint16_t usAddress;
     /* Leave register R26 - R31 untouched */
     pxTopOfStack -= 7;
 
+    /* Tasks start from a full frame, so the parameter is restored to R24 - R25. */
+    *pxTopOfStack = portFULL_FRAME_TAG;
+    pxTopOfStack--;
+
     return pxTopOfStack;
 }
 /*-----------------------------------------------------------*/
@@ -608,6 +1223,16 @@ BaseType_t xPortStartScheduler( void )
     /* Setup the relevant timer hardware to generate the tick. */
     prvSetupTimerInterrupt();
 
+#if ( configISR_STACK_SIZE > 0 )
+    /* main() will not run again, so interrupts can use its stack. */
+    ucPortISRStackReady = pdTRUE;
+#endif
+
+#if ( configRECLAIM_MAIN_STACK == 1 )
+    /* The rest of the main() stack is free for the heap, from the first task onwards. */
+    vPortHeapAddMainStack();
+#endif
+
     /* Restore the context of the first task that is going to run. */
     portRESTORE_CONTEXT();
 
@@ -625,18 +1250,318 @@ void vPortEndScheduler( void )
     /* It is unlikely that the ATmega port will get stopped.  If required simply
      * disable the tick interrupt here. */
 
+#if defined( portUSE_WDTO )
     wdt_disable();      /* disable Watchdog Timer */
+#elif defined( portUSE_TIMER0_MILLIS )
+    TIMSK0 &= ~_BV( OCIE0A );               /* disable Timer0 compare match interrupt, leaving millis() running */
+#elif defined( portSCHEDULER_ISR )
+    portTIMER_TIMSK &= ~portTIMER_OCIEA;    /* disable Timer compare match interrupt */
+#endif
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Read the actual Tick period, which may be updated by the tick ISR.
+ */
+static __inline__ uint32_t prvGetTickPeriodUs( void ) __attribute__ ( ( always_inline ) );
+static __inline__ uint32_t prvGetTickPeriodUs( void )
+{
+    uint32_t ulTickPeriodUs;
+
+    portENTER_CRITICAL();
+    ulTickPeriodUs = portTickPeriodUs;
+    portEXIT_CRITICAL();
+
+    return ulTickPeriodUs;
+}
+
+/*
+ * Convert milliseconds to Ticks, using the actual Tick period.
+ */
+static TickType_t prvMsToTicks( const uint32_t ms, const uint32_t ulTickPeriodUs )
+{
+    if( ms < ( UINT32_MAX / 1000UL ) )
+    {
+        return (TickType_t)( ( ms * 1000UL ) / ulTickPeriodUs );
+    }
+
+    /* split, so the Tick period may be shorter than 1ms. */
+    return (TickType_t)( ( ms / ulTickPeriodUs ) * 1000UL + ( ( ms % ulTickPeriodUs ) * 1000UL ) / ulTickPeriodUs );
+}
+
+TickType_t xPortMsToTicks( const uint32_t ms )
+{
+    return prvMsToTicks( ms, prvGetTickPeriodUs() );
+}
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_KERNEL_INTERRUPT_MASK == 1 )
+
+/* The kernel aware interrupts of the port itself, added to portKERNEL_INTERRUPTS. */
+#if ( configUSE_PORT_DELAY_US == 1 )
+    #define portPORT_INTERRUPTS( X )    X( portTIMER_TIMSK, portTIMER_OCIEB )
+#else
+    #define portPORT_INTERRUPTS( X )
+#endif
+
+/* The enable bits of each kernel aware interrupt that were set on entry. */
+#define portDECLARE_MASK( reg, bits )   static uint8_t ucMask_##reg;
+    portKERNEL_INTERRUPTS( portDECLARE_MASK )
+    portPORT_INTERRUPTS( portDECLARE_MASK )
+
+#endif /* configUSE_KERNEL_INTERRUPT_MASK == 1 */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_PORT_DELAY_US == 1 )
+
+extern unsigned long micros( void );
+
+/* Timer counts per millisecond, and the Tick period in microseconds. */
+#define portTIMER_COUNTS_PER_MS     ( ( portTIMER_CLOCK_HZ ) / ( portTIMER_PRESCALER * 1000UL ) )
+#define portTICK_PERIOD_US          ( 1000000UL / ( configTICK_RATE_HZ ) )
+
+/* Wake times closer than this are treated as already passed. */
+#define portDELAY_US_MARGIN         8
+
+/*
+ * A task waiting for a microsecond wake time, on the waiting task's stack.
+ * The list is sorted by wake time, and compare match B of the tick Timer is
+ * set for the first wake time.
+ */
+typedef struct xDELAY_US_WAITER
+{
+    struct xDELAY_US_WAITER * pxNext;
+    TaskHandle_t xTask;
+    uint32_t ulWakeUs;
+} DelayUsWaiter_t;
+
+static DelayUsWaiter_t * volatile pxDelayUsWaiters = NULL;
+
+/*
+ * Set compare match B for a wake time less than one Tick away. The Timer
+ * passes every compare value once each Tick, so a compare match can be late
+ * by up to one Tick but is never lost. Called from the compare match ISR, or
+ * from a task in a critical section, which enables the interrupt itself.
+ */
+static void prvSetDelayUsCompare( int32_t lRemainingUs )
+{
+    uint32_t ulCompare;
+
+    if( lRemainingUs > (int32_t)portTICK_PERIOD_US )
+    {
+        lRemainingUs = (int32_t)portTICK_PERIOD_US;
+    }
+
+    ulCompare = (uint32_t)portTIMER_TCNT + ( (uint32_t)lRemainingUs * portTIMER_COUNTS_PER_MS ) / 1000UL;
+    if( ulCompare > portTIMER_COMPARE )
+    {
+        ulCompare = portTIMER_COMPARE;
+    }
+
+    portTIMER_OCRB = (uint16_t)ulCompare;
+    portTIMER_TIFR = portTIMER_OCFB;
+}
+
+/*
+ * Remove the waiter of a task from the list, if it is still there. Called
+ * with interrupts disabled, or in a critical section.
+ */
+static void prvRemoveDelayUsWaiter( const TaskHandle_t xTask )
+{
+    DelayUsWaiter_t * volatile * ppxNext = &pxDelayUsWaiters;
+
+    while( *ppxNext != NULL )
+    {
+        if( ( *ppxNext )->xTask == xTask )
+        {
+            *ppxNext = ( *ppxNext )->pxNext;
+            break;
+        }
+
+        ppxNext = &( ( *ppxNext )->pxNext );
+    }
 }
+
+/*
+ * Block until the wake time, in whole Ticks with vTaskDelay() until the wake
+ * time is within the current Tick, then with compare match B of the tick Timer.
+ * The task is suspended inside a critical section, so the compare match ISR
+ * can't resume it before it is suspended. A task resumed early by vTaskResume()
+ * removes its own waiter, and waits again for the rest of the time.
+ */
+static void prvDelayUntilUs( const uint32_t ulWakeUs )
+{
+    DelayUsWaiter_t xWaiter;
+    DelayUsWaiter_t * volatile * ppxNext;
+    int32_t lRemainingUs;
+
+    for( ;; )
+    {
+        lRemainingUs = (int32_t)( ulWakeUs - micros() );
+
+        if( lRemainingUs <= portDELAY_US_MARGIN )
+        {
+            return;
+        }
+
+        if( lRemainingUs >= (int32_t)portTICK_PERIOD_US )
+        {
+            /* Ticks end before the wake time, as the current Tick is partly over. */
+            vTaskDelay( (TickType_t)configMIN( (uint32_t)lRemainingUs / portTICK_PERIOD_US, (uint32_t)( portMAX_DELAY >> 1 ) ) );
+            continue;
+        }
+
+        portENTER_CRITICAL();
+
+        lRemainingUs = (int32_t)( ulWakeUs - micros() );
+
+        /* Wait for the Tick containing the wake time. */
+        if( (uint32_t)portTIMER_TCNT + ( (uint32_t)lRemainingUs * portTIMER_COUNTS_PER_MS ) / 1000UL > portTIMER_COMPARE )
+        {
+            portEXIT_CRITICAL();
+            vTaskDelay( 1 );
+            continue;
+        }
+
+        xWaiter.xTask = xTaskGetCurrentTaskHandle();
+        xWaiter.ulWakeUs = ulWakeUs;
+
+        ppxNext = &pxDelayUsWaiters;
+        while( ( *ppxNext != NULL ) && ( (int32_t)( ( *ppxNext )->ulWakeUs - ulWakeUs ) <= 0 ) )
+        {
+            ppxNext = &( ( *ppxNext )->pxNext );
+        }
+        xWaiter.pxNext = *ppxNext;
+        *ppxNext = &xWaiter;
+
+        if( pxDelayUsWaiters == &xWaiter )
+        {
+            prvSetDelayUsCompare( lRemainingUs );
+
+#if ( configUSE_KERNEL_INTERRUPT_MASK == 1 )
+            /* The critical section leaves interrupts enabled, so the compare match
+             * is enabled by vPortExitCritical(), once the task is suspended. */
+            ucMask_portTIMER_TIMSK |= portTIMER_OCIEB;
+#else
+            portTIMER_TIMSK |= portTIMER_OCIEB;
+#endif
+        }
+
+        vTaskSuspend( NULL );
+        portEXIT_CRITICAL();
+
+        /* the waiter is on this stack, so it mustn't stay in the list. */
+        portENTER_CRITICAL();
+        prvRemoveDelayUsWaiter( xWaiter.xTask );
+        portEXIT_CRITICAL();
+    }
+}
+
+void vPortDelayUsCleanUp( void * pxTCB )
+{
+    portENTER_CRITICAL();
+    prvRemoveDelayUsWaiter( ( TaskHandle_t ) pxTCB );
+    portEXIT_CRITICAL();
+}
+
+void vPortDelayUs( const uint32_t us )
+{
+    prvDelayUntilUs( (uint32_t)micros() + us );
+}
+
+void vPortDelayUntilUs( uint32_t * const pulPreviousWakeUs, const uint32_t ulIncrementUs )
+{
+    *pulPreviousWakeUs += ulIncrementUs;
+    prvDelayUntilUs( *pulPreviousWakeUs );
+}
+
+/*
+ * Compare match B ISR. Resume the tasks whose wake time has passed, and set
+ * the compare match for the next one.
+ */
+ISR( portDELAY_US_ISR ) __attribute__ ( ( hot, flatten ) );
+ISR( portDELAY_US_ISR )
+{
+    BaseType_t xTaskWoken = pdFALSE;
+    DelayUsWaiter_t * pxWaiter;
+    uint32_t ulNowUs = micros();
+
+    while( ( ( pxWaiter = pxDelayUsWaiters ) != NULL ) && ( (int32_t)( pxWaiter->ulWakeUs - ulNowUs ) <= portDELAY_US_MARGIN ) )
+    {
+        pxDelayUsWaiters = pxWaiter->pxNext;
+        xTaskWoken |= xTaskResumeFromISR( pxWaiter->xTask );
+    }
+
+    if( pxWaiter != NULL )
+    {
+        prvSetDelayUsCompare( (int32_t)( pxWaiter->ulWakeUs - ulNowUs ) );
+    }
+    else
+    {
+        portTIMER_TIMSK &= ~portTIMER_OCIEB;
+    }
+
+    if( xTaskWoken != pdFALSE )
+    {
+        portYIELD_FROM_ISR();
+    }
+}
+
+#endif /* configUSE_PORT_DELAY_US == 1 */
+/*-----------------------------------------------------------*/
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+
+#if defined( portUSE_TIMER0 )
+    #warning "The run time stats counter relies on the Arduino Timer0 configuration."
+#endif
+
+extern volatile unsigned long timer0_overflow_count;
+
+/*
+ * Run time counter in Timer0 counts, 4us at 16MHz, built from the Arduino
+ * Timer0 overflow count and TCNT0 in the same way as micros(). Leaving out the
+ * scaling to microseconds keeps it cheap, as it is read on every context switch.
+ */
+uint32_t ulPortGetRunTimeCounterValue( void )
+{
+    uint32_t ulOverflows;
+    uint8_t ucCount;
+    uint8_t ucSREG = SREG;
+
+    portDISABLE_INTERRUPTS();   /* not a critical section, as the Arduino Timer0 ISR is never masked */
+
+    ulOverflows = timer0_overflow_count;
+    ucCount = TCNT0;
+
+    /* an overflow that hasn't been serviced yet. */
+#if defined( TIFR0 )
+    if( ( TIFR0 & _BV( TOV0 ) ) && ( ucCount < 255 ) )
+#else
+    if( ( TIFR & _BV( TOV0 ) ) && ( ucCount < 255 ) )
+#endif
+    {
+        ++ulOverflows;
+    }
+
+    SREG = ucSREG;
+
+    return ( ulOverflows << 8 ) | ucCount;
+}
+
+#endif /* configGENERATE_RUN_TIME_STATS == 1 */
 /*-----------------------------------------------------------*/
 
 /*
  * Choose which delay function to use.
  * Arduino delay() is a millisecond granularity busy wait, that
  * that breaks FreeRTOS. So its use is limited to less than one
- * System Tick (portTICK_PERIOD_MS milliseconds).
+ * System Tick (portTickPeriodUs microseconds).
  * FreeRTOS vTaskDelay() is relies on the System Tick which here
- * has a granularity of portTICK_PERIOD_MS milliseconds (15ms),
+ * has a granularity of portTickPeriodUs microseconds (15ms for the WDT),
  * with the remainder implemented as an Arduino delay().
+ * The conversion uses the actual Tick period, portTickPeriodUs,
+ * which is measured when the WDT calibration is enabled.
  */
 
 #ifdef delay
@@ -645,18 +1570,35 @@ void vPortEndScheduler( void )
 
 extern void delay ( unsigned long ms );
 
-#if defined( portUSE_WDTO )
+#if defined( portSCHEDULER_ISR )
 void vPortDelay( const uint32_t ms ) __attribute__ ( ( hot, flatten ) );
 void vPortDelay( const uint32_t ms )
 {
-    if ( ms < portTICK_PERIOD_MS )
+#if ( configUSE_PORT_DELAY_US == 1 )
+    /* block for the whole delay, without a busy wait remainder. */
+    if ( ms < ( INT32_MAX / 1000L ) )
+    {
+        vPortDelayUs( ms * 1000UL );
+        return;
+    }
+#endif
+
+    uint32_t ulTickPeriodUs = prvGetTickPeriodUs();
+    TickType_t xTicks = prvMsToTicks( ms, ulTickPeriodUs );
+
+    if ( xTicks == 0 )
     {
         delay( (unsigned long) (ms) );
     }
     else
     {
-        vTaskDelay( (TickType_t) (ms / portTICK_PERIOD_MS) );
-        delay( (unsigned long) ( (ms - portTICK_PERIOD_MS) % portTICK_PERIOD_MS ) );
+        vTaskDelay( xTicks );
+
+        /* the remainder of less than one Tick, using the actual Tick period. */
+        if ( ms < ( UINT32_MAX / 1000UL ) )
+        {
+            delay( (unsigned long) ( ( ms * 1000UL - (uint32_t)xTicks * ulTickPeriodUs ) / 1000UL ) );
+        }
     }
 }
 #else
@@ -668,12 +1610,14 @@ extern void vPortDelay( const uint32_t ms ) __attribute__ ( ( hot, flatten ) );
 
 /*
  * Manual context switch. The first thing we do is save the registers so we
- * can use a naked attribute.
+ * can use a naked attribute. As this is only called as a function, the
+ * shorter voluntary frame is sufficient.
  */
 void vPortYield( void ) __attribute__( ( hot, flatten, naked ) );
 void vPortYield( void )
 {
-    portSAVE_CONTEXT();
+    portSAVE_VOLUNTARY_CONTEXT();
+    portSWITCH_TO_ISR_STACK();
     vTaskSwitchContext();
     portRESTORE_CONTEXT();
 
@@ -689,6 +1633,7 @@ void vPortYieldFromISR( void ) __attribute__( ( hot, flatten, naked ) );
 void vPortYieldFromISR( void )
 {
     portSAVE_CONTEXT();
+    portSWITCH_TO_ISR_STACK();
     vTaskSwitchContext();
     portRESTORE_CONTEXT();
 
@@ -696,28 +1641,401 @@ void vPortYieldFromISR( void )
 }
 /*-----------------------------------------------------------*/
 
+#if ( configISR_STACK_SIZE > 0 )
+
+/*
+ * Restore the registers saved by vPortISRStackEntry(), and the r24 and r25
+ * pushed by the portISR_STACK() interrupt vector.
+ */
+#if defined(__AVR_HAVE_RAMPZ__)
+#define portISR_STACK_RESTORE                                                           \
+                                "pop    r31                                     \n\t"   \
+                                "pop    r30                                     \n\t"   \
+                                "pop    r27                                     \n\t"   \
+                                "pop    r26                                     \n\t"   \
+                                "pop    r23                                     \n\t"   \
+                                "pop    r22                                     \n\t"   \
+                                "pop    r21                                     \n\t"   \
+                                "pop    r20                                     \n\t"   \
+                                "pop    r19                                     \n\t"   \
+                                "pop    r18                                     \n\t"   \
+                                "pop    __zero_reg__                            \n\t"   \
+                                "pop    __tmp_reg__                             \n\t"   \
+                                "out    0x3B, __tmp_reg__                       \n\t"   \
+                                "pop    __tmp_reg__                             \n\t"   \
+                                "out    __SREG__, __tmp_reg__                   \n\t"   \
+                                "pop    __tmp_reg__                             \n\t"   \
+                                "pop    r25                                     \n\t"   \
+                                "pop    r24                                     \n\t"
+#else
+#define portISR_STACK_RESTORE                                                           \
+                                "pop    r31                                     \n\t"   \
+                                "pop    r30                                     \n\t"   \
+                                "pop    r27                                     \n\t"   \
+                                "pop    r26                                     \n\t"   \
+                                "pop    r23                                     \n\t"   \
+                                "pop    r22                                     \n\t"   \
+                                "pop    r21                                     \n\t"   \
+                                "pop    r20                                     \n\t"   \
+                                "pop    r19                                     \n\t"   \
+                                "pop    r18                                     \n\t"   \
+                                "pop    __zero_reg__                            \n\t"   \
+                                "pop    __tmp_reg__                             \n\t"   \
+                                "out    __SREG__, __tmp_reg__                   \n\t"   \
+                                "pop    __tmp_reg__                             \n\t"   \
+                                "pop    r25                                     \n\t"   \
+                                "pop    r24                                     \n\t"
+#endif /* if defined( __AVR_HAVE_RAMPZ__ ) */
+
+/*
+ * Common entry for the interrupts defined with portISR_STACK(). The vector has
+ * pushed r24 and r25, and loaded the handler address into them. The rest of the
+ * call-clobbered registers are saved on the task stack, then the handler runs
+ * on the interrupt stack. If the handler returns pdTRUE, the interrupt exits
+ * through vPortYieldFromISR(), from the task stack.
+ *
+ * Before the scheduler has started, main() is still using the interrupt stack,
+ * so the handler runs on the main() stack.
+ */
+void vPortISRStackEntry( void ) __attribute__( ( hot, naked, used ) );
+void vPortISRStackEntry( void )
+{
+    __asm__ __volatile__ (  "push   __tmp_reg__                             \n\t"
+                            "in     __tmp_reg__, __SREG__                   \n\t"
+                            "push   __tmp_reg__                             \n\t"
+#if defined(__AVR_HAVE_RAMPZ__)
+                            "in     __tmp_reg__, 0x3B                       \n\t"
+                            "push   __tmp_reg__                             \n\t"
+#endif
+                            "push   __zero_reg__                            \n\t"
+                            "clr    __zero_reg__                            \n\t"
+                            "push   r18                                     \n\t"
+                            "push   r19                                     \n\t"
+                            "push   r20                                     \n\t"
+                            "push   r21                                     \n\t"
+                            "push   r22                                     \n\t"
+                            "push   r23                                     \n\t"
+                            "push   r26                                     \n\t"
+                            "push   r27                                     \n\t"
+                            "push   r30                                     \n\t"
+                            "push   r31                                     \n\t"
+                            "movw   r30, r24                                \n\t"
+                            "in     r26, __SP_L__                           \n\t"
+                            "in     r27, __SP_H__                           \n\t"
+                            "sts    usPortTaskStackPointer, r26             \n\t"
+                            "sts    usPortTaskStackPointer + 1, r27         \n\t"
+                            "lds    r26, ucPortISRStackReady                \n\t"
+                            "tst    r26                                     \n\t"
+                            "breq   1f                                      \n\t"
+                            "ldi    r26, lo8(%[top])                        \n\t"
+                            "ldi    r27, hi8(%[top])                        \n\t"
+                            "out    __SP_L__, r26                           \n\t"
+                            "out    __SP_H__, r27                           \n\t"
+                            "1:                                             \n\t"
+#if defined(__AVR_3_BYTE_PC__)
+                            "eicall                                         \n\t"
+#else
+                            "icall                                          \n\t"
+#endif
+                            "lds    r26, usPortTaskStackPointer             \n\t"
+                            "lds    r27, usPortTaskStackPointer + 1         \n\t"
+                            "out    __SP_L__, r26                           \n\t"
+                            "out    __SP_H__, r27                           \n\t"
+                            "tst    r24                                     \n\t"
+                            "brne   2f                                      \n\t"
+                            portISR_STACK_RESTORE
+                            "reti                                           \n\t"
+                            "2:                                             \n\t"
+                            portISR_STACK_RESTORE
+                            "%~jmp  vPortYieldFromISR                       \n\t"
+                            :: [top] "i" ( portISR_STACK_TOP )
+                         );
+}
+
+#endif /* configISR_STACK_SIZE > 0 */
+/*-----------------------------------------------------------*/
+
+#if defined( portUSE_WDTO ) && ( portCALIBRATE_WDTO == 1 )
+
+    /*
+     * Measure one Watchdog period against Timer0, which the Arduino init() has
+     * started from the crystal clock. Interrupts are still disabled, so the WDT
+     * interrupt flag is polled rather than serviced, and the Timer0 counts are
+     * accumulated here rather than by the Arduino overflow ISR.
+     */
+    static void prvCalibrateWatchdog( void )
+    {
+        static const uint16_t usTimer0Prescaler[ 8 ] PROGMEM = { 0, 1, 8, 64, 256, 1024, 0, 0 };
+
+        uint16_t usPrescaler = pgm_read_word( &usTimer0Prescaler[ TCCR0B & 0x07 ] );
+        uint32_t ulCounts = 0;
+        uint32_t ulCycles;
+        uint8_t ucLast, ucNow;
+
+        /* Timer0 must be running from the system clock, and counting up to 0xFF. */
+        if( ( usPrescaler == 0 ) || ( ( TCCR0A & ( _BV( WGM01 ) | _BV( WGM00 ) ) ) == _BV( WGM00 ) ) ||
+            ( ( TCCR0A & ( _BV( WGM01 ) | _BV( WGM00 ) ) ) == _BV( WGM01 ) ) || ( TCCR0B & _BV( WGM02 ) ) )
+        {
+            return;
+        }
+
+        wdt_reset();
+        wdt_interrupt_enable( portUSE_WDTO );
+
+        /* synchronise with the end of the first WDT period. */
+        while( ( _WD_CONTROL_REG & _BV( WDIF ) ) == 0 ) {}
+        _WD_CONTROL_REG |= _BV( WDIF );
+
+        ucLast = TCNT0;
+        while( ( _WD_CONTROL_REG & _BV( WDIF ) ) == 0 )
+        {
+            ucNow = TCNT0;
+            ulCounts += (uint8_t)( ucNow - ucLast );
+            ucLast = ucNow;
+        }
+        _WD_CONTROL_REG |= _BV( WDIF );    /* don't leave a tick pending */
+
+        /* convert CPU cycles to microseconds, in two steps to avoid overflow. */
+        ulCycles = ulCounts * usPrescaler;
+        portTickPeriodUs = ( ulCycles / ( F_CPU / 1000UL ) ) * 1000UL + ( ( ulCycles % ( F_CPU / 1000UL ) ) * 1000UL ) / ( F_CPU / 1000UL );
+        portTickRateHz = (TickType_t)( ( 1000000UL + ( portTickPeriodUs >> 1 ) ) / portTickPeriodUs );
+    }
+
+#endif /* defined( portUSE_WDTO ) && ( portCALIBRATE_WDTO == 1 ) */
+
+#if defined( portUSE_WDTO ) && ( portRECALIBRATE_WDTO_TICKS > 0 )
+
+    extern unsigned long micros( void );
+
+    static uint32_t ulLastCalibrationUs;
+    static uint16_t usTicksToCalibration = portRECALIBRATE_WDTO_TICKS;
+
+    /*
+     * Remeasure the WDT period against the Arduino micros(), averaged over
+     * portRECALIBRATE_WDTO_TICKS Ticks. Called from the tick ISR.
+     */
+    static __inline__ void prvRecalibrateWatchdog( void ) __attribute__ ( ( always_inline ) );
+    static __inline__ void prvRecalibrateWatchdog( void )
+    {
+        if( --usTicksToCalibration == 0 )
+        {
+            uint32_t ulNowUs = micros();
+
+            portTickPeriodUs = ( ulNowUs - ulLastCalibrationUs ) / portRECALIBRATE_WDTO_TICKS;
+            portTickRateHz = (TickType_t)( ( 1000000UL + ( portTickPeriodUs >> 1 ) ) / portTickPeriodUs );
+
+            ulLastCalibrationUs = ulNowUs;
+            usTicksToCalibration = portRECALIBRATE_WDTO_TICKS;
+        }
+    }
+
+    /*
+     * Restart the measurement, as micros() doesn't count during a tickless sleep.
+     */
+    static __inline__ void prvRestartWatchdogCalibration( void ) __attribute__ ( ( always_inline ) );
+    static __inline__ void prvRestartWatchdogCalibration( void )
+    {
+        ulLastCalibrationUs = micros();
+        usTicksToCalibration = portRECALIBRATE_WDTO_TICKS;
+    }
+
+#endif /* defined( portUSE_WDTO ) && ( portRECALIBRATE_WDTO_TICKS > 0 ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_TICKLESS_IDLE == 1 ) && defined( portSCHEDULER_ISR )
+
+    /* Set while the Tick period is stretched to cover a tickless sleep. */
+    static volatile uint8_t ucTickStretched;
+
+    /*
+     * The stretched Tick has expired, so restore the normal Tick period.
+     * Called from the tick ISR.
+     */
+    static __inline__ void prvRestoreTick( void ) __attribute__ ( ( always_inline ) );
+    static __inline__ void prvRestoreTick( void )
+    {
+        if( ucTickStretched != 0 )
+        {
+            ucTickStretched = 0;
+
+#if defined( portUSE_WDTO )
+            wdt_interrupt_enable( portUSE_WDTO );
+#else
+            portTIMER_OCRA = portTIMER_COMPARE;
+#endif
+        }
+    }
+
+#endif /* ( configUSE_TICKLESS_IDLE == 1 ) && defined( portSCHEDULER_ISR ) */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_KERNEL_INTERRUPT_MASK == 1 )
+
+    /* Critical sections leave interrupts enabled, so the nesting is counted here,
+     * and the Ticks and yield during a critical section are held until it exits. */
+    static volatile UBaseType_t uxCriticalNesting = 0;
+    static volatile UBaseType_t uxTicksPending = 0;
+    static volatile uint8_t ucYieldPending = pdFALSE;
+
+#endif /* configUSE_KERNEL_INTERRUPT_MASK == 1 */
+/*-----------------------------------------------------------*/
+
+/*
+ * Increment the tick, called from vPortYieldFromTick() with only the
+ * call-clobbered registers saved. This must not be inlined, so that it
+ * saves any call-saved registers it uses itself.
+ */
+static BaseType_t prvIncrementTick( void ) __attribute__( ( hot, noinline ) );
+static BaseType_t prvIncrementTick( void )
+{
+#if ( configUSE_KERNEL_INTERRUPT_MASK == 1 )
+    if( uxCriticalNesting != 0 )
+    {
+        ++uxTicksPending;           /* processed by vPortExitCritical() */
+        return pdFALSE;
+    }
+#endif
+
+    sleep_reset();        /* reset the sleep_mode() faster than sleep_disable(); */
+
+#if ( configUSE_TICKLESS_IDLE == 1 )
+    prvRestoreTick();
+#endif
+
+#if defined( portUSE_WDTO ) && ( portRECALIBRATE_WDTO_TICKS > 0 )
+    prvRecalibrateWatchdog();
+#endif
+
+    return xTaskIncrementTick();
+}
+/*-----------------------------------------------------------*/
+
 /*
  * Context switch function used by the tick. This must be identical to
  * vPortYield() from the call to vTaskSwitchContext() onwards. The only
  * difference from vPortYield() is the tick count is incremented as the
  * call comes from the tick ISR.
+ *
+ * Most ticks neither unblock a task nor end a time slice, so the tick is
+ * incremented with only the call-clobbered registers saved. Only when
+ * xTaskIncrementTick() requires a context switch is the full context saved.
+ *
+ * With configISR_STACK_SIZE, xTaskIncrementTick() and vTaskSwitchContext()
+ * run on the interrupt stack, and only the saved context is on the task stack.
  */
 void vPortYieldFromTick( void ) __attribute__( ( hot, flatten, naked ) );
 void vPortYieldFromTick( void )
 {
-    portSAVE_CONTEXT();
-    sleep_reset();        /* reset the sleep_mode() faster than sleep_disable(); */
-    if( xTaskIncrementTick() != pdFALSE )
+    portSAVE_TICK_CONTEXT();
+    portSWITCH_TO_ISR_STACK();
+    if( prvIncrementTick() == pdFALSE )
     {
-        vTaskSwitchContext();
+        portSWITCH_TO_TASK_STACK();
+        portRESTORE_TICK_CONTEXT();
+        __asm__ __volatile__ ( "ret" );
     }
+    portSWITCH_TO_TASK_STACK();
+    portRESTORE_TICK_CONTEXT();
 
+    portSAVE_CONTEXT();
+    portSWITCH_TO_ISR_STACK();
+    vTaskSwitchContext();
     portRESTORE_CONTEXT();
 
     __asm__ __volatile__ ( "ret" );
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_KERNEL_INTERRUPT_MASK == 1 )
+
+#define portMASK( reg, bits )           ucMask_##reg = reg & ( bits ); reg &= ~( bits );
+#define portUNMASK( reg, bits )         reg |= ucMask_##reg;
+
+    /*
+     * Enter a critical section by disabling only the kernel aware interrupts,
+     * listed in portKERNEL_INTERRUPTS. Other interrupts stay enabled, and must
+     * not use the FreeRTOS API. The Tick isn't disabled, but is held pending.
+     */
+    void vPortEnterCritical( void )
+    {
+        uint8_t ucSREG = SREG;
+
+        portDISABLE_INTERRUPTS();
+
+        if( uxCriticalNesting++ == 0 )
+        {
+            portKERNEL_INTERRUPTS( portMASK )
+            portPORT_INTERRUPTS( portMASK )
+        }
+
+        SREG = ucSREG;
+    }
+
+    /*
+     * Exit a critical section. When the outermost critical section exits, enable
+     * the kernel aware interrupts again, then process each Tick held while it
+     * was entered, so a long critical section doesn't lose Ticks, and yield once
+     * if any of them, or the critical section itself, needed a context switch.
+     */
+    void vPortExitCritical( void )
+    {
+        uint8_t ucSREG = SREG;
+
+        portDISABLE_INTERRUPTS();
+
+        if( --uxCriticalNesting == 0 )
+        {
+            portKERNEL_INTERRUPTS( portUNMASK )
+            portPORT_INTERRUPTS( portUNMASK )
+
+            /* called with interrupts disabled, as it would be from the tick ISR. */
+            while( uxTicksPending != 0 )
+            {
+                --uxTicksPending;
+
+#if ( configUSE_PREEMPTION == 1 )
+                if( prvIncrementTick() != pdFALSE )
+                {
+                    ucYieldPending = pdTRUE;
+                }
+#else
+                ( void ) prvIncrementTick();
+#endif
+            }
+
+            SREG = ucSREG;
+
+            if( ucYieldPending != pdFALSE )
+            {
+                ucYieldPending = pdFALSE;
+                vPortYield();
+            }
+        }
+        else
+        {
+            SREG = ucSREG;
+        }
+    }
+
+    /*
+     * Yield, unless in a critical section. Then the yield is held until the
+     * critical section exits, as the interrupt mask isn't part of the task context.
+     */
+    void vPortYieldOutsideCritical( void )
+    {
+        if( uxCriticalNesting != 0 )
+        {
+            ucYieldPending = pdTRUE;
+        }
+        else
+        {
+            vPortYield();
+        }
+    }
+
+#endif /* configUSE_KERNEL_INTERRUPT_MASK == 1 */
+/*-----------------------------------------------------------*/
+
 #if defined( portUSE_WDTO )
 
     /*
@@ -725,6 +2043,15 @@ void vPortYieldFromTick( void )
      */
     void prvSetupTimerInterrupt( void )
     {
+#if ( portCALIBRATE_WDTO == 1 )
+        /* measure the actual WDT period against the crystal clock. */
+        prvCalibrateWatchdog();
+#endif
+
+#if ( portRECALIBRATE_WDTO_TICKS > 0 )
+        ulLastCalibrationUs = micros();
+#endif
+
         /* reset watchdog */
         wdt_reset();
 
@@ -732,6 +2059,67 @@ void vPortYieldFromTick( void )
         wdt_interrupt_enable( portUSE_WDTO );
     }
 
+#elif defined( portUSE_TIMER0_MILLIS )
+
+    /*
+     * Share Timer0 with the Arduino millis(), micros() and delay() functions.
+     *
+     * Timer0 is left running as configured by the Arduino init(), in 8-bit
+     * fast PWM mode with a prescaler of 64, and its TIMER0_OVF_vect ISR stays
+     * owned by the Arduino core. The compare match A interrupt fires exactly
+     * once for each overflow, so it generates the tick at the overflow rate.
+     * OCR0A is double buffered in PWM mode, so analogWrite() on its pin doesn't
+     * lose or add a tick.
+     */
+    void prvSetupTimerInterrupt( void )
+    {
+        /* clear any stale compare match, then enable the interrupt. */
+        TIFR0 = _BV( OCF0A );
+        TIMSK0 |= _BV( OCIE0A );
+    }
+
+#elif defined( portSCHEDULER_ISR )
+
+#if defined( portTIMER_ASYNC )
+
+    /*
+     * Registers of the asynchronous Timer2 are written through the TOSC clock
+     * domain, which takes up to two TOSC cycles. Wait until this has finished.
+     */
+    static __inline__ void prvTimerAsyncWait( void ) __attribute__ ( ( always_inline ) );
+    static __inline__ void prvTimerAsyncWait( void )
+    {
+        while( ASSR & ( _BV( TCN2UB ) | _BV( OCR2AUB ) | _BV( OCR2BUB ) | _BV( TCR2AUB ) | _BV( TCR2BUB ) ) ) {}
+    }
+
+#endif /* defined( portTIMER_ASYNC ) */
+
+    /*
+     * Setup Timer in CTC mode to generate a tick interrupt on compare match A.
+     * Any Arduino PWM configuration of this Timer is overwritten.
+     */
+    void prvSetupTimerInterrupt( void )
+    {
+        /* stop the Timer, and remove any Arduino PWM configuration. */
+        portTIMER_TIMSK &= ~portTIMER_OCIEA;
+        portTIMER_TCCRB = 0x00;
+#if defined( portTIMER_ASYNC )
+        ASSR = _BV( AS2 );      /* clock Timer2 from the TOSC crystal */
+#endif
+        portTIMER_TCCRA = portTIMER_CTC_A;
+
+        portTIMER_OCRA = portTIMER_COMPARE;
+        portTIMER_TCNT = 0;
+
+        /* start the Timer in CTC mode, and enable the compare match interrupt. */
+        portTIMER_TCCRB = portTIMER_CTC_B | portTIMER_CS;
+#if defined( portTIMER_ASYNC )
+        prvTimerAsyncWait();
+#endif
+        portTIMER_TIFR = portTIMER_OCFA;
+        portTIMER_TIMSK |= portTIMER_OCIEA;
+    }
+
 #else
     #warning "The user is responsible to provide function `prvSetupTimerInterrupt()`"
     extern void prvSetupTimerInterrupt( void );
@@ -739,12 +2127,238 @@ void vPortYieldFromTick( void )
 
 /*-----------------------------------------------------------*/
 
-#if configUSE_PREEMPTION == 1
+#if ( configUSE_TICKLESS_IDLE == 1 ) && defined( portSCHEDULER_ISR )
+
+#if !defined( portTICKLESS_SLEEP_MODE )
+    #if defined( portUSE_WDTO )
+        #define portTICKLESS_SLEEP_MODE     SLEEP_MODE_PWR_DOWN     /* only the WDT oscillator is needed */
+    #elif defined( portTIMER_ASYNC )
+        #define portTICKLESS_SLEEP_MODE     SLEEP_MODE_PWR_SAVE     /* Timer2 keeps counting from the TOSC crystal */
+    #else
+        #define portTICKLESS_SLEEP_MODE     SLEEP_MODE_IDLE         /* the Timer is clocked from the CPU clock */
+    #endif
+#endif
+
+#if defined( WDTO_8S )
+    #define portTICKLESS_WDTO_MAX           WDTO_8S
+#else
+    #define portTICKLESS_WDTO_MAX           WDTO_2S
+#endif
+
+    /*
+     * Stretch the Tick to cover the expected idle time, and sleep.
+     *
+     * Called by the Idle task with the scheduler suspended. Interrupts that
+     * don't make a task ready put the MCU straight back to sleep. When woken,
+     * the Ticks that passed while asleep are added with vTaskStepTick(), and
+     * the ISR of the stretched Tick adds the final Tick itself.
+     */
+    void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+    {
+        TickType_t xStretchedTicks;
+        TickType_t xCompletedTicks;
+
+#if defined( portUSE_WDTO )
+        uint8_t ucPeriod = portUSE_WDTO;
+
+        /* The WDT periods are powers of two, so choose the longest that
+         * ends before the expected idle time. */
+        xStretchedTicks = 1;
+        while( ( ucPeriod < portTICKLESS_WDTO_MAX ) && ( ( xStretchedTicks << 1 ) <= xExpectedIdleTime ) )
+        {
+            ++ucPeriod;
+            xStretchedTicks <<= 1;
+        }
+#else
+        uint16_t usCount;
+        uint16_t usCompare;
+
+        xStretchedTicks = configMIN( xExpectedIdleTime, (TickType_t)( portTIMER_MAX_COUNT / portTIMER_COUNTS_PER_TICK ) );
+#endif
+
+        if( xStretchedTicks < 2 )
+        {
+            return;
+        }
+
+#if ( configUSE_PORT_DELAY_US == 1 )
+        /* A microsecond delay is less than one Tick away, so don't stretch the Tick. */
+        if( pxDelayUsWaiters != NULL )
+        {
+            return;
+        }
+#endif
+
+        portDISABLE_INTERRUPTS();
+
+        /* Don't sleep if a task was made ready after the idle time was calculated. */
+        if( eTaskConfirmSleepModeStatus() == eAbortSleep )
+        {
+            portENABLE_INTERRUPTS();
+            return;
+        }
+
+#if defined( portUSE_WDTO )
+
+        /* Don't sleep through a Tick that is already pending. */
+        if( _WD_CONTROL_REG & _BV( WDIF ) )
+        {
+            portENABLE_INTERRUPTS();
+            return;
+        }
+
+        /* restarting the WDT loses the part of the current Tick already passed. */
+        wdt_interrupt_enable( ucPeriod );
+
+#if ( portRECALIBRATE_WDTO_TICKS > 0 )
+        usTicksToCalibration = 0;       /* wraps in the ISR, so nothing is measured across the sleep */
+#endif
+
+#elif defined( portTIMER_ASYNC )
+
+        prvTimerAsyncWait();
+        if( portTIMER_TIFR & portTIMER_OCFA )
+        {
+            portENABLE_INTERRUPTS();
+            return;
+        }
+
+        /* Timer2 keeps counting, so the compare match may happen before the
+         * stretched compare value reaches the TOSC clock domain. */
+        portTIMER_OCRA = (uint8_t)( xStretchedTicks * portTIMER_COUNTS_PER_TICK - 1 );
+        prvTimerAsyncWait();
+        if( portTIMER_TIFR & portTIMER_OCFA )
+        {
+            portTIMER_OCRA = portTIMER_COMPARE;
+            prvTimerAsyncWait();
+            portENABLE_INTERRUPTS();
+            return;
+        }
+
+#else
+
+        /* Stop the Timer, so the compare value can be changed safely. */
+        portTIMER_TCCRB = portTIMER_CTC_B;
+        if( portTIMER_TIFR & portTIMER_OCFA )
+        {
+            portTIMER_TCCRB = portTIMER_CTC_B | portTIMER_CS;
+            portENABLE_INTERRUPTS();
+            return;
+        }
+
+        portTIMER_OCRA = (uint16_t)( (uint32_t)xStretchedTicks * portTIMER_COUNTS_PER_TICK - 1 );
+        portTIMER_TCCRB = portTIMER_CTC_B | portTIMER_CS;
+
+#endif
+
+        ucTickStretched = 1;
+
+        for( ;; )
+        {
+            set_sleep_mode( portTICKLESS_SLEEP_MODE );
+            sleep_enable();
+#if defined( sleep_bod_disable ) && ( portTICKLESS_SLEEP_MODE != SLEEP_MODE_IDLE )
+            sleep_bod_disable();
+#endif
+            portENABLE_INTERRUPTS();    /* the instruction following sei is always executed, so no wake up is missed */
+            sleep_cpu();
+            portDISABLE_INTERRUPTS();
+            sleep_disable();
+
+            /* Stop sleeping when the stretched Tick has expired, or a task was made ready. */
+            if( ( ucTickStretched == 0 ) || ( eTaskConfirmSleepModeStatus() == eAbortSleep ) )
+            {
+                break;
+            }
+
+#if defined( portTIMER_ASYNC )
+            /* wait for one TOSC cycle before sleeping again, as required after a Timer2 wake up. */
+            portTIMER_TCCRB = portTIMER_CTC_B | portTIMER_CS;
+            prvTimerAsyncWait();
+#endif
+        }
+
+#if defined( portUSE_WDTO )
+
+        if( ( ucTickStretched == 0 ) || ( _WD_CONTROL_REG & _BV( WDIF ) ) )
+        {
+            xCompletedTicks = xStretchedTicks - 1;
+        }
+        else
+        {
+            /* Woken early. The WDT count can't be read, so the time asleep is lost. */
+            xCompletedTicks = 0;
+            ucTickStretched = 0;
+            wdt_interrupt_enable( portUSE_WDTO );
+        }
+
+#if ( portRECALIBRATE_WDTO_TICKS > 0 )
+        prvRestartWatchdogCalibration();
+#endif
+
+#else
+
+#if defined( portTIMER_ASYNC )
+        /* wait for one TOSC cycle, so TCNT2 can be read after the wake up. */
+        portTIMER_TCCRB = portTIMER_CTC_B | portTIMER_CS;
+        prvTimerAsyncWait();
+#else
+        portTIMER_TCCRB = portTIMER_CTC_B;
+#endif
+
+        if( ( ucTickStretched == 0 ) || ( portTIMER_TIFR & portTIMER_OCFA ) )
+        {
+            xCompletedTicks = xStretchedTicks - 1;
+        }
+        else
+        {
+            /* Woken early. Count the complete Ticks, and move the compare match
+             * to the end of the current Tick, where the ISR restores the Tick. */
+            usCount = portTIMER_TCNT;
+            xCompletedTicks = (TickType_t)( usCount / portTIMER_COUNTS_PER_TICK );
+
+            if( xCompletedTicks < xStretchedTicks - 1 )
+            {
+                usCompare = (uint16_t)( ( xCompletedTicks + 1 ) * portTIMER_COUNTS_PER_TICK - 1 );
+
+#if defined( portTIMER_ASYNC )
+                /* too close to the end of this Tick to move the compare in time, so use the next one. */
+                if( usCompare - usCount < 2 )
+                {
+                    ++xCompletedTicks;
+                    usCompare += portTIMER_COUNTS_PER_TICK;
+                }
+#endif
+                portTIMER_OCRA = usCompare;
+            }
+        }
+
+#if defined( portTIMER_ASYNC )
+        prvTimerAsyncWait();
+#else
+        portTIMER_TCCRB = portTIMER_CTC_B | portTIMER_CS;
+#endif
+
+#endif /* defined( portUSE_WDTO ) */
+
+        if( xCompletedTicks != 0 )
+        {
+            vTaskStepTick( xCompletedTicks );
+        }
+
+        portENABLE_INTERRUPTS();
+    }
+
+#endif /* ( configUSE_TICKLESS_IDLE == 1 ) && defined( portSCHEDULER_ISR ) */
+
+/*-----------------------------------------------------------*/
+
+#if defined( portSCHEDULER_ISR ) && ( configUSE_PREEMPTION == 1 )
 
     /*
      * Tick ISR for preemptive scheduler. We can use a naked attribute as
      * the context is saved at the start of vPortYieldFromTick(). The tick
-     * count is incremented after the context is saved.
+     * count is incremented after the call-clobbered registers are saved.
      *
      * use ISR_NOBLOCK where there is an important timer running, that should preempt the scheduler.
      *
@@ -758,7 +2372,7 @@ void vPortYieldFromTick( void )
         vPortYieldFromTick();
         __asm__ __volatile__ ( "reti" );
     }
-#else /* if configUSE_PREEMPTION == 1 */
+#elif defined( portSCHEDULER_ISR ) && ( configISR_STACK_SIZE == 0 )
 
     /*
      * Tick ISR for the cooperative scheduler. All this does is increment the
@@ -773,6 +2387,24 @@ void vPortYieldFromTick( void )
  */
     ISR( portSCHEDULER_ISR )
     {
-        xTaskIncrementTick();
+        ( void ) prvIncrementTick();
+    }
+#elif defined( portSCHEDULER_ISR ) && ( configISR_STACK_SIZE > 0 )
+
+    /*
+     * Tick ISR for the cooperative scheduler, incrementing the tick count on
+     * the interrupt stack. Naked, so the registers are saved on the task stack
+     * before the stack pointer is moved.
+     */
+    ISR( portSCHEDULER_ISR, ISR_NAKED ) __attribute__ ( ( hot, flatten ) );
+
+    ISR( portSCHEDULER_ISR )
+    {
+        portSAVE_TICK_CONTEXT();
+        portSWITCH_TO_ISR_STACK();
+        ( void ) prvIncrementTick();
+        portSWITCH_TO_TASK_STACK();
+        portRESTORE_TICK_CONTEXT();
+        __asm__ __volatile__ ( "reti" );
     }
-#endif /* if configUSE_PREEMPTION == 1 */
+#endif /* if defined( portSCHEDULER_ISR ) && ( configUSE_PREEMPTION == 1 ) */
@@ -30,6 +30,7 @@
 #define PORTMACRO_H
 
 #include <avr/wdt.h>
+#include <avr/pgmspace.h>
 
 /* *INDENT-OFF* */
 #ifdef __cplusplus
@@ -68,6 +69,16 @@ typedef uint8_t             UBaseType_t;
 
 /* Critical section management. */
 
+#if ( configUSE_KERNEL_INTERRUPT_MASK == 1 )
+
+/* Mask only the kernel aware interrupts, listed by portKERNEL_INTERRUPTS in FreeRTOSVariant.h. */
+extern void vPortEnterCritical( void );
+extern void vPortExitCritical( void );
+#define portENTER_CRITICAL()        vPortEnterCritical()
+#define portEXIT_CRITICAL()         vPortExitCritical()
+
+#else
+
 #define portENTER_CRITICAL()                        \
     __asm__ __volatile__ (                          \
         "in __tmp_reg__, __SREG__"        "\n\t"    \
@@ -84,6 +95,7 @@ typedef uint8_t             UBaseType_t;
         ::: "memory"                                \
         )
 
+#endif /* configUSE_KERNEL_INTERRUPT_MASK == 1 */
 
 #define portDISABLE_INTERRUPTS()    __asm__ __volatile__ ( "cli" ::: "memory" )
 #define portENABLE_INTERRUPTS()     __asm__ __volatile__ ( "sei" ::: "memory" )
@@ -103,11 +115,103 @@ typedef uint8_t             UBaseType_t;
 extern void vPortDelay( const uint32_t ms );
 #define portDELAY( ms )         vPortDelay( ms )
 
+#if ( configUSE_PORT_DELAY_US == 1 )
+/* Block for a number of microseconds, or until a periodic wake time, without a busy wait. */
+extern void vPortDelayUs( const uint32_t us );
+extern void vPortDelayUntilUs( uint32_t * const pulPreviousWakeUs, const uint32_t ulIncrementUs );
+#define vTaskDelayUs( us )                                  vPortDelayUs( us )
+#define vTaskDelayUntilUs( pulPreviousWakeUs, ulIncrementUs )   vPortDelayUntilUs( pulPreviousWakeUs, ulIncrementUs )
+/* A deleted task may still be waiting, with its waiter on the stack about to be freed. */
+extern void vPortDelayUsCleanUp( void * pxTCB );
+#define portCLEAN_UP_TCB( pxTCB )                           vPortDelayUsCleanUp( pxTCB )
+#endif
+
+/* Convert milliseconds to Ticks at run time, using the actual (calibrated) Tick period. */
+extern volatile uint32_t portTickPeriodUs;
+extern volatile TickType_t portTickRateHz;
+extern TickType_t xPortMsToTicks( const uint32_t ms );
+#define portMS_TO_TICKS( ms )   xPortMsToTicks( ms )
+
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+/* The run time counter is the Arduino Timer0, already running for millis(), counting at F_CPU / 64. */
+extern uint32_t ulPortGetRunTimeCounterValue( void );
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()    ulPortGetRunTimeCounterValue()
+#endif
+
 extern void vPortYield( void )      __attribute__( ( naked ) );
+#if ( configUSE_KERNEL_INTERRUPT_MASK == 1 )
+extern void vPortYieldOutsideCritical( void );
+#define portYIELD()             vPortYieldOutsideCritical()
+#else
 #define portYIELD()             vPortYield()
+#endif
 
 extern void vPortYieldFromISR( void )   __attribute__( ( naked ) );
 #define portYIELD_FROM_ISR()    vPortYieldFromISR()
+
+#ifndef configTASK_NAMES_IN_PROGMEM
+    #define configTASK_NAMES_IN_PROGMEM     0
+#endif
+
+#ifndef configTASK_RECYCLE_POOL_SIZE
+    #define configTASK_RECYCLE_POOL_SIZE    0
+#endif
+
+#ifndef configUSE_BASIC_TASKS
+    #define configUSE_BASIC_TASKS       0
+#endif
+
+#ifndef configUSE_HEAP_AVR
+    #define configUSE_HEAP_AVR          0
+#endif
+
+#if ( configUSE_HEAP_AVR == 1 )
+/* Allocate from the external SRAM heap (portUSE_XMEM) if it has room, otherwise from the internal RAM. */
+extern void * pvPortMallocExternal( size_t xWantedSize );
+#endif
+
+#ifndef configRECLAIM_MAIN_STACK
+    #define configRECLAIM_MAIN_STACK    0
+#endif
+
+#if ( configRECLAIM_MAIN_STACK == 1 )
+/* Give the main() stack to the heap, once the scheduler has started. Provided by the heap implementation. */
+extern void vPortHeapAddMainStack( void );
+#endif
+
+#ifndef configISR_STACK_SIZE
+    #define configISR_STACK_SIZE    0
+#endif
+
+#if ( configISR_STACK_SIZE > 0 )
+/* Define an interrupt vector that runs handler() on the interrupt stack, rather than the task stack.
+ * handler() takes no arguments, must not enable interrupts, and returns pdTRUE to request a context switch
+ * instead of calling portYIELD_FROM_ISR(). */
+extern void vPortISRStackEntry( void );
+#ifdef __cplusplus
+    #define portISR_STACK_LINKAGE   extern "C"
+#else
+    #define portISR_STACK_LINKAGE
+#endif
+#define portISR_STACK( vector, handler )                                        \
+    portISR_STACK_LINKAGE BaseType_t handler( void );                           \
+    ISR( vector, ISR_NAKED )                                                    \
+    {                                                                           \
+        __asm__ __volatile__ (  "push   r24                         \n\t"       \
+                                "push   r25                         \n\t"       \
+                                "ldi    r24, lo8(gs(" #handler "))  \n\t"       \
+                                "ldi    r25, hi8(gs(" #handler "))  \n\t"       \
+                                "%~jmp  vPortISRStackEntry          \n\t"       \
+                                ::                                              \
+                             );                                                 \
+    }
+#endif
+
+#if ( configUSE_TICKLESS_IDLE == 1 )
+extern void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )    vPortSuppressTicksAndSleep( xExpectedIdleTime )
+#endif
 /*-----------------------------------------------------------*/
 
 #if defined( __AVR_3_BYTE_PC__ )
@@ -122,6 +226,49 @@ extern void vPortYieldFromISR( void )   __attribute__( ( naked ) );
 #endif
 
 #define portTASK_FUNCTION( vFunction, pvParameters )              void vFunction( void * pvParameters )
+/*-----------------------------------------------------------*/
+
+/* Port optimised task selection. */
+
+#ifndef configUSE_PORT_OPTIMISED_TASK_SELECTION
+    #define configUSE_PORT_OPTIMISED_TASK_SELECTION    1
+#endif
+
+#if configUSE_PORT_OPTIMISED_TASK_SELECTION == 1
+
+/* uxTopReadyPriority is an 8-bit bitmap of the priorities that have ready tasks,
+ * so the maximum number of priorities that can be supported is 8. */
+    #if ( configMAX_PRIORITIES > 8 )
+        #error configUSE_PORT_OPTIMISED_TASK_SELECTION can only be set to 1 when configMAX_PRIORITIES is less than or equal to 8.
+    #endif
+
+/* Lookup tables held in flash, defined in port.c.
+ * ucPortPriorityBitMask[ n ] is _BV( n ), avoiding the variable shift loop.
+ * ucPortHighestBitInNibble[ n ] is the index of the most significant set bit of n. */
+    extern const uint8_t ucPortPriorityBitMask[ 8 ] PROGMEM;
+    extern const uint8_t ucPortHighestBitInNibble[ 16 ] PROGMEM;
+
+/* Store/clear the ready priorities in a bit map. */
+    #define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities )    ( uxReadyPriorities ) |= pgm_read_byte( &ucPortPriorityBitMask[ ( uxPriority ) ] )
+    #define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities )     ( uxReadyPriorities ) &= ~pgm_read_byte( &ucPortPriorityBitMask[ ( uxPriority ) ] )
+
+/* Find the highest set bit using one nibble test and one flash table lookup. */
+    static __inline__ UBaseType_t uxPortGetHighestPriority( UBaseType_t uxReadyPriorities ) __attribute__( ( __always_inline__ ) );
+    static __inline__ UBaseType_t uxPortGetHighestPriority( UBaseType_t uxReadyPriorities )
+    {
+        uint8_t ucHighNibble = ( uint8_t ) ( uxReadyPriorities >> 4 );     /* compiles to swap, andi */
+
+        if( ucHighNibble != 0 )
+        {
+            return ( UBaseType_t ) ( 4 + pgm_read_byte( &ucPortHighestBitInNibble[ ucHighNibble ] ) );
+        }
+
+        return ( UBaseType_t ) pgm_read_byte( &ucPortHighestBitInNibble[ uxReadyPriorities ] );
+    }
+
+    #define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities )    uxTopPriority = uxPortGetHighestPriority( ( uxReadyPriorities ) )
+
+#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
 
 /* *INDENT-OFF* */
 #ifdef __cplusplus
@@ -203,6 +203,53 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
 static void prvCopyDataFromQueue( Queue_t * const pxQueue,
                                   void * const pvBuffer ) PRIVILEGED_FUNCTION;
 
+/*
+ * Copies one item of uxItemSize bytes.  Items of 1, 2 and 4 bytes, the common
+ * case, are moved with inline loads and stores, which is much quicker than a
+ * call to memcpy() while interrupts are disabled.
+ */
+static __inline__ void prvCopyItem( void * const pvDestination,
+                                    const void * const pvSource,
+                                    const UBaseType_t uxItemSize ) __attribute__( ( always_inline ) );
+
+/*
+ * Blocks the calling task until the queue has space (xForSpace is pdTRUE) or
+ * contains an item, without adding or removing an item.  Used by the
+ * zero-copy acquire functions, which then work in the queue storage area.
+ *
+ * @return pdPASS if the queue became ready, or pdFAIL if xTicksToWait expired.
+ */
+static BaseType_t prvWaitForQueue( Queue_t * const pxQueue,
+                                   TickType_t xTicksToWait,
+                                   const BaseType_t xForSpace ) PRIVILEGED_FUNCTION;
+
+/*
+ * The blocking half of the send and receive loops, called when the queue was
+ * not ready and a timeout has been set.  Places the calling task on the event
+ * list for space (xForSpace is pdTRUE) or data if the queue is still not ready
+ * and the timeout has not expired.  When the timeout expires *pxTicksToWait is
+ * set to zero, so the caller's next loop leaves if the queue is not ready.
+ */
+static void prvBlockOnQueue( Queue_t * const pxQueue,
+                             TimeOut_t * const pxTimeOut,
+                             TickType_t * const pxTicksToWait,
+                             const BaseType_t xForSpace ) PRIVILEGED_FUNCTION;
+
+/*
+ * Copy as many as possible of uxItems items into the back of the queue, or out
+ * of the front of the queue, in at most two blocks.  Called from a critical
+ * section.
+ *
+ * @return The number of items copied.
+ */
+static UBaseType_t prvCopyItemsToQueue( Queue_t * const pxQueue,
+                                        const void * pvItems,
+                                        const UBaseType_t uxItems ) PRIVILEGED_FUNCTION;
+
+static UBaseType_t prvCopyItemsFromQueue( Queue_t * const pxQueue,
+                                          void * pvItems,
+                                          const UBaseType_t uxItems ) PRIVILEGED_FUNCTION;
+
 #if ( configUSE_QUEUE_SETS == 1 )
 
 /*
@@ -1642,25 +1689,12 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
 }
 /*-----------------------------------------------------------*/
 
-BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
-                                TickType_t xTicksToWait )
+static BaseType_t prvWaitForQueue( Queue_t * const pxQueue,
+                                   TickType_t xTicksToWait,
+                                   const BaseType_t xForSpace )
 {
-    BaseType_t xEntryTimeSet = pdFALSE;
+    BaseType_t xEntryTimeSet = pdFALSE, xReady;
     TimeOut_t xTimeOut;
-    Queue_t * const pxQueue = xQueue;
-
-    #if ( configUSE_MUTEXES == 1 )
-        BaseType_t xInheritanceOccurred = pdFALSE;
-    #endif
-
-    traceENTER_xQueueSemaphoreTake( xQueue, xTicksToWait );
-
-    /* Check the queue pointer is not NULL. */
-    configASSERT( ( pxQueue ) );
-
-    /* Check this really is a semaphore, in which case the item size will be
-     * 0. */
-    configASSERT( pxQueue->uxItemSize == 0 );
 
     /* Cannot block if the scheduler is suspended. */
     #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
@@ -1673,234 +1707,882 @@ BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
     {
         taskENTER_CRITICAL();
         {
-            /* Semaphores are queues with an item size of 0, and where the
-             * number of messages in the queue is the semaphore's count value. */
-            const UBaseType_t uxSemaphoreCount = pxQueue->uxMessagesWaiting;
-
-            /* Is there data in the queue now?  To be running the calling task
-             * must be the highest priority task wanting to access the queue. */
-            if( uxSemaphoreCount > ( UBaseType_t ) 0 )
+            if( xForSpace != pdFALSE )
             {
-                traceQUEUE_RECEIVE( pxQueue );
-
-                /* Semaphores are queues with a data size of zero and where the
-                 * messages waiting is the semaphore's count.  Reduce the count. */
-                pxQueue->uxMessagesWaiting = ( UBaseType_t ) ( uxSemaphoreCount - ( UBaseType_t ) 1 );
-
-                #if ( configUSE_MUTEXES == 1 )
-                {
-                    if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
-                    {
-                        /* Record the information required to implement
-                         * priority inheritance should it become necessary. */
-                        pxQueue->u.xSemaphore.xMutexHolder = pvTaskIncrementMutexHeldCount();
-                    }
-                    else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
-                }
-                #endif /* configUSE_MUTEXES */
-
-                /* Check to see if other tasks are blocked waiting to give the
-                 * semaphore, and if so, unblock the highest priority such task. */
-                if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
-                {
-                    if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
-                    {
-                        queueYIELD_IF_USING_PREEMPTION();
-                    }
-                    else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
-                }
-                else
-                {
-                    mtCOVERAGE_TEST_MARKER();
-                }
+                xReady = ( pxQueue->uxMessagesWaiting < pxQueue->uxLength ) ? pdTRUE : pdFALSE;
+            }
+            else
+            {
+                xReady = ( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 ) ? pdTRUE : pdFALSE;
+            }
 
+            if( xReady != pdFALSE )
+            {
                 taskEXIT_CRITICAL();
 
-                traceRETURN_xQueueSemaphoreTake( pdPASS );
-
                 return pdPASS;
             }
-            else
+            else if( xTicksToWait == ( TickType_t ) 0 )
             {
-                if( xTicksToWait == ( TickType_t ) 0 )
-                {
-                    /* The semaphore count was 0 and no block time is specified
-                     * (or the block time has expired) so exit now. */
-                    taskEXIT_CRITICAL();
-
-                    traceQUEUE_RECEIVE_FAILED( pxQueue );
-                    traceRETURN_xQueueSemaphoreTake( errQUEUE_EMPTY );
+                /* The queue was not ready and no block time is specified (or
+                 * the block time has expired) so leave now. */
+                taskEXIT_CRITICAL();
 
-                    return errQUEUE_EMPTY;
-                }
-                else if( xEntryTimeSet == pdFALSE )
-                {
-                    /* The semaphore count was 0 and a block time was specified
-                     * so configure the timeout structure ready to block. */
-                    vTaskInternalSetTimeOutState( &xTimeOut );
-                    xEntryTimeSet = pdTRUE;
-                }
-                else
-                {
-                    /* Entry time was already set. */
-                    mtCOVERAGE_TEST_MARKER();
-                }
+                return pdFAIL;
+            }
+            else if( xEntryTimeSet == pdFALSE )
+            {
+                vTaskInternalSetTimeOutState( &xTimeOut );
+                xEntryTimeSet = pdTRUE;
+            }
+            else
+            {
+                /* Entry time was already set. */
+                mtCOVERAGE_TEST_MARKER();
             }
         }
         taskEXIT_CRITICAL();
 
-        /* Interrupts and other tasks can give to and take from the semaphore
-         * now the critical section has been exited. */
+        prvBlockOnQueue( pxQueue, &xTimeOut, &xTicksToWait, xForSpace );
+    }
+}
+/*-----------------------------------------------------------*/
 
-        vTaskSuspendAll();
-        prvLockQueue( pxQueue );
+static void prvBlockOnQueue( Queue_t * const pxQueue,
+                             TimeOut_t * const pxTimeOut,
+                             TickType_t * const pxTicksToWait,
+                             const BaseType_t xForSpace )
+{
+    BaseType_t xReady;
 
-        /* Update the timeout state to see if it has expired yet. */
-        if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
-        {
-            /* A block time is specified and not expired.  If the semaphore
-             * count is 0 then enter the Blocked state to wait for a semaphore to
-             * become available.  As semaphores are implemented with queues the
-             * queue being empty is equivalent to the semaphore count being 0. */
-            if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
-            {
-                traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+    /* Interrupts and other tasks can send to and receive from the queue
+     * now the critical section has been exited. */
 
-                #if ( configUSE_MUTEXES == 1 )
-                {
-                    if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
-                    {
-                        taskENTER_CRITICAL();
-                        {
-                            xInheritanceOccurred = xTaskPriorityInherit( pxQueue->u.xSemaphore.xMutexHolder );
-                        }
-                        taskEXIT_CRITICAL();
-                    }
-                    else
-                    {
-                        mtCOVERAGE_TEST_MARKER();
-                    }
-                }
-                #endif /* if ( configUSE_MUTEXES == 1 ) */
+    vTaskSuspendAll();
+    prvLockQueue( pxQueue );
 
-                vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
-                prvUnlockQueue( pxQueue );
+    /* Update the timeout state to see if it has expired yet. */
+    if( xTaskCheckForTimeOut( pxTimeOut, pxTicksToWait ) == pdFALSE )
+    {
+        if( xForSpace != pdFALSE )
+        {
+            xReady = ( prvIsQueueFull( pxQueue ) == pdFALSE ) ? pdTRUE : pdFALSE;
+        }
+        else
+        {
+            xReady = ( prvIsQueueEmpty( pxQueue ) == pdFALSE ) ? pdTRUE : pdFALSE;
+        }
 
-                if( xTaskResumeAll() == pdFALSE )
-                {
-                    taskYIELD_WITHIN_API();
-                }
-                else
-                {
-                    mtCOVERAGE_TEST_MARKER();
-                }
+        if( xReady == pdFALSE )
+        {
+            if( xForSpace != pdFALSE )
+            {
+                traceBLOCKING_ON_QUEUE_SEND( pxQueue );
+                vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToSend ), *pxTicksToWait );
             }
             else
             {
-                /* There was no timeout and the semaphore count was not 0, so
-                 * attempt to take the semaphore again. */
-                prvUnlockQueue( pxQueue );
-                ( void ) xTaskResumeAll();
+                traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+                vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), *pxTicksToWait );
             }
-        }
-        else
-        {
-            /* Timed out. */
+
             prvUnlockQueue( pxQueue );
-            ( void ) xTaskResumeAll();
 
-            /* If the semaphore count is 0 exit now as the timeout has
-             * expired.  Otherwise return to attempt to take the semaphore that is
-             * known to be available.  As semaphores are implemented by queues the
-             * queue being empty is equivalent to the semaphore count being 0. */
-            if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+            if( xTaskResumeAll() == pdFALSE )
             {
-                #if ( configUSE_MUTEXES == 1 )
-                {
-                    /* xInheritanceOccurred could only have be set if
-                     * pxQueue->uxQueueType == queueQUEUE_IS_MUTEX so no need to
-                     * test the mutex type again to check it is actually a mutex. */
-                    if( xInheritanceOccurred != pdFALSE )
-                    {
-                        taskENTER_CRITICAL();
-                        {
-                            UBaseType_t uxHighestWaitingPriority;
-
-                            /* This task blocking on the mutex caused another
-                             * task to inherit this task's priority.  Now this task
-                             * has timed out the priority should be disinherited
-                             * again, but only as low as the next highest priority
-                             * task that is waiting for the same mutex. */
-                            uxHighestWaitingPriority = prvGetDisinheritPriorityAfterTimeout( pxQueue );
-
-                            /* vTaskPriorityDisinheritAfterTimeout uses the uxHighestWaitingPriority
-                             * parameter to index pxReadyTasksLists when adding the task holding
-                             * mutex to the ready list for its new priority. Coverity thinks that
-                             * it can result in out-of-bounds access which is not true because
-                             * uxHighestWaitingPriority, as returned by prvGetDisinheritPriorityAfterTimeout,
-                             * is capped at ( configMAX_PRIORITIES - 1 ). */
-                            /* coverity[overrun] */
-                            vTaskPriorityDisinheritAfterTimeout( pxQueue->u.xSemaphore.xMutexHolder, uxHighestWaitingPriority );
-                        }
-                        taskEXIT_CRITICAL();
-                    }
-                }
-                #endif /* configUSE_MUTEXES */
-
-                traceQUEUE_RECEIVE_FAILED( pxQueue );
-                traceRETURN_xQueueSemaphoreTake( errQUEUE_EMPTY );
-
-                return errQUEUE_EMPTY;
+                taskYIELD_WITHIN_API();
             }
             else
             {
                 mtCOVERAGE_TEST_MARKER();
             }
         }
+        else
+        {
+            /* Try again. */
+            prvUnlockQueue( pxQueue );
+            ( void ) xTaskResumeAll();
+        }
+    }
+    else
+    {
+        /* Timed out, so *pxTicksToWait is now zero. */
+        prvUnlockQueue( pxQueue );
+        ( void ) xTaskResumeAll();
     }
 }
 /*-----------------------------------------------------------*/
 
-BaseType_t xQueuePeek( QueueHandle_t xQueue,
-                       void * const pvBuffer,
-                       TickType_t xTicksToWait )
+void * pvQueueAcquireSend( QueueHandle_t xQueue,
+                           TickType_t xTicksToWait )
 {
-    BaseType_t xEntryTimeSet = pdFALSE;
-    TimeOut_t xTimeOut;
-    int8_t * pcOriginalReadPosition;
     Queue_t * const pxQueue = xQueue;
+    void * pvItem = NULL;
 
-    traceENTER_xQueuePeek( xQueue, pvBuffer, xTicksToWait );
-
-    /* Check the pointer is not NULL. */
-    configASSERT( ( pxQueue ) );
+    traceENTER_pvQueueAcquireSend( xQueue, xTicksToWait );
 
-    /* The buffer into which data is received can only be NULL if the data size
-     * is zero (so no data is copied into the buffer. */
-    configASSERT( !( ( ( pvBuffer ) == NULL ) && ( ( pxQueue )->uxItemSize != ( UBaseType_t ) 0U ) ) );
+    configASSERT( pxQueue );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
 
-    /* Cannot block if the scheduler is suspended. */
-    #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+    if( prvWaitForQueue( pxQueue, xTicksToWait, pdTRUE ) != pdFAIL )
     {
-        configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+        /* Only the acquiring task moves pcWriteTo, so the item stays free
+         * until it is committed. */
+        pvItem = ( void * ) pxQueue->pcWriteTo;
     }
-    #endif
-
-    for( ; ; )
+    else
     {
-        taskENTER_CRITICAL();
-        {
-            const UBaseType_t uxMessagesWaiting = pxQueue->uxMessagesWaiting;
+        traceQUEUE_SEND_FAILED( pxQueue );
+    }
 
-            /* Is there data in the queue now?  To be running the calling task
-             * must be the highest priority task wanting to access the queue. */
-            if( uxMessagesWaiting > ( UBaseType_t ) 0 )
+    traceRETURN_pvQueueAcquireSend( pvItem );
+
+    return pvItem;
+}
+/*-----------------------------------------------------------*/
+
+void vQueueCommitSend( QueueHandle_t xQueue )
+{
+    Queue_t * const pxQueue = xQueue;
+
+    traceENTER_vQueueCommitSend( xQueue );
+
+    configASSERT( pxQueue );
+
+    taskENTER_CRITICAL();
+    {
+        configASSERT( pxQueue->uxMessagesWaiting < pxQueue->uxLength );
+
+        traceQUEUE_SEND( pxQueue );
+
+        pxQueue->pcWriteTo += pxQueue->uxItemSize;
+
+        if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail )
+        {
+            pxQueue->pcWriteTo = pxQueue->pcHead;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        pxQueue->uxMessagesWaiting = ( UBaseType_t ) ( pxQueue->uxMessagesWaiting + ( UBaseType_t ) 1 );
+
+        #if ( configUSE_QUEUE_SETS == 1 )
+            if( pxQueue->pxQueueSetContainer != NULL )
+            {
+                if( prvNotifyQueueSetContainer( pxQueue ) != pdFALSE )
+                {
+                    queueYIELD_IF_USING_PREEMPTION();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+        #endif /* configUSE_QUEUE_SETS */
+
+        /* If there was a task waiting for data to arrive on the queue then
+         * unblock it now. */
+        if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+        {
+            if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+            {
+                queueYIELD_IF_USING_PREEMPTION();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    traceRETURN_vQueueCommitSend();
+}
+/*-----------------------------------------------------------*/
+
+const void * pvQueueAcquireReceive( QueueHandle_t xQueue,
+                                    TickType_t xTicksToWait )
+{
+    Queue_t * const pxQueue = xQueue;
+    int8_t * pcItem = NULL;
+
+    traceENTER_pvQueueAcquireReceive( xQueue, xTicksToWait );
+
+    configASSERT( pxQueue );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+
+    if( prvWaitForQueue( pxQueue, xTicksToWait, pdFALSE ) != pdFAIL )
+    {
+        /* Only the acquiring task moves pcReadFrom, so the item stays in the
+         * queue until it is released. */
+        pcItem = pxQueue->u.xQueue.pcReadFrom + pxQueue->uxItemSize;
+
+        if( pcItem >= pxQueue->u.xQueue.pcTail )
+        {
+            pcItem = pxQueue->pcHead;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        traceQUEUE_RECEIVE_FAILED( pxQueue );
+    }
+
+    traceRETURN_pvQueueAcquireReceive( pcItem );
+
+    return ( const void * ) pcItem;
+}
+/*-----------------------------------------------------------*/
+
+void vQueueReleaseReceive( QueueHandle_t xQueue )
+{
+    Queue_t * const pxQueue = xQueue;
+
+    traceENTER_vQueueReleaseReceive( xQueue );
+
+    configASSERT( pxQueue );
+
+    taskENTER_CRITICAL();
+    {
+        configASSERT( pxQueue->uxMessagesWaiting > ( UBaseType_t ) 0 );
+
+        traceQUEUE_RECEIVE( pxQueue );
+
+        pxQueue->u.xQueue.pcReadFrom += pxQueue->uxItemSize;
+
+        if( pxQueue->u.xQueue.pcReadFrom >= pxQueue->u.xQueue.pcTail )
+        {
+            pxQueue->u.xQueue.pcReadFrom = pxQueue->pcHead;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        pxQueue->uxMessagesWaiting = ( UBaseType_t ) ( pxQueue->uxMessagesWaiting - ( UBaseType_t ) 1 );
+
+        /* There is now space in the queue, were any tasks waiting to post to
+         * the queue?  If so, unblock the highest priority waiting task. */
+        if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
+        {
+            if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+            {
+                queueYIELD_IF_USING_PREEMPTION();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    traceRETURN_vQueueReleaseReceive();
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueSendMultiple( QueueHandle_t xQueue,
+                                 const void * const pvItems,
+                                 const UBaseType_t uxItems,
+                                 TickType_t xTicksToWait )
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+    Queue_t * const pxQueue = xQueue;
+    UBaseType_t uxSent;
+
+    traceENTER_uxQueueSendMultiple( xQueue, pvItems, uxItems, xTicksToWait );
+
+    configASSERT( pxQueue );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    configASSERT( !( ( pvItems == NULL ) && ( uxItems != ( UBaseType_t ) 0U ) ) );
+
+    #if ( configUSE_QUEUE_SETS == 1 )
+    {
+        /* A queue set is only notified once for each item sent. */
+        configASSERT( pxQueue->pxQueueSetContainer == NULL );
+    }
+    #endif
+
+    #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+    {
+        configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+    }
+    #endif
+
+    if( uxItems == ( UBaseType_t ) 0U )
+    {
+        traceRETURN_uxQueueSendMultiple( ( UBaseType_t ) 0U );
+
+        return ( UBaseType_t ) 0U;
+    }
+
+    for( ; ; )
+    {
+        taskENTER_CRITICAL();
+        {
+            uxSent = prvCopyItemsToQueue( pxQueue, pvItems, uxItems );
+
+            if( uxSent > ( UBaseType_t ) 0U )
+            {
+                traceQUEUE_SEND( pxQueue );
+
+                /* Unblock one task waiting for data, however many items were
+                 * sent. */
+                if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+                {
+                    if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE )
+                    {
+                        queueYIELD_IF_USING_PREEMPTION();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                taskEXIT_CRITICAL();
+
+                traceRETURN_uxQueueSendMultiple( uxSent );
+
+                return uxSent;
+            }
+            else if( xTicksToWait == ( TickType_t ) 0 )
+            {
+                /* The queue was full and no block time is specified (or the
+                 * block time has expired) so leave now. */
+                taskEXIT_CRITICAL();
+
+                traceQUEUE_SEND_FAILED( pxQueue );
+                traceRETURN_uxQueueSendMultiple( ( UBaseType_t ) 0U );
+
+                return ( UBaseType_t ) 0U;
+            }
+            else if( xEntryTimeSet == pdFALSE )
+            {
+                vTaskInternalSetTimeOutState( &xTimeOut );
+                xEntryTimeSet = pdTRUE;
+            }
+            else
+            {
+                /* Entry time was already set. */
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        prvBlockOnQueue( pxQueue, &xTimeOut, &xTicksToWait, pdTRUE );
+    }
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueReceiveMultiple( QueueHandle_t xQueue,
+                                    void * const pvItems,
+                                    const UBaseType_t uxItems,
+                                    TickType_t xTicksToWait )
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+    Queue_t * const pxQueue = xQueue;
+    UBaseType_t uxReceived;
+
+    traceENTER_uxQueueReceiveMultiple( xQueue, pvItems, uxItems, xTicksToWait );
+
+    configASSERT( pxQueue );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    configASSERT( !( ( pvItems == NULL ) && ( uxItems != ( UBaseType_t ) 0U ) ) );
+
+    #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+    {
+        configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+    }
+    #endif
+
+    if( uxItems == ( UBaseType_t ) 0U )
+    {
+        traceRETURN_uxQueueReceiveMultiple( ( UBaseType_t ) 0U );
+
+        return ( UBaseType_t ) 0U;
+    }
+
+    for( ; ; )
+    {
+        taskENTER_CRITICAL();
+        {
+            uxReceived = prvCopyItemsFromQueue( pxQueue, pvItems, uxItems );
+
+            if( uxReceived > ( UBaseType_t ) 0U )
+            {
+                traceQUEUE_RECEIVE( pxQueue );
+
+                /* Unblock one task waiting for space, however many items were
+                 * received. */
+                if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
+                {
+                    if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+                    {
+                        queueYIELD_IF_USING_PREEMPTION();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                taskEXIT_CRITICAL();
+
+                traceRETURN_uxQueueReceiveMultiple( uxReceived );
+
+                return uxReceived;
+            }
+            else if( xTicksToWait == ( TickType_t ) 0 )
+            {
+                /* The queue was empty and no block time is specified (or the
+                 * block time has expired) so leave now. */
+                taskEXIT_CRITICAL();
+
+                traceQUEUE_RECEIVE_FAILED( pxQueue );
+                traceRETURN_uxQueueReceiveMultiple( ( UBaseType_t ) 0U );
+
+                return ( UBaseType_t ) 0U;
+            }
+            else if( xEntryTimeSet == pdFALSE )
+            {
+                vTaskInternalSetTimeOutState( &xTimeOut );
+                xEntryTimeSet = pdTRUE;
+            }
+            else
+            {
+                /* Entry time was already set. */
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        prvBlockOnQueue( pxQueue, &xTimeOut, &xTicksToWait, pdFALSE );
+    }
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueSendMultipleFromISR( QueueHandle_t xQueue,
+                                        const void * const pvItems,
+                                        const UBaseType_t uxItems,
+                                        BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    UBaseType_t uxSavedInterruptStatus;
+    Queue_t * const pxQueue = xQueue;
+    UBaseType_t uxSent;
+
+    traceENTER_uxQueueSendMultipleFromISR( xQueue, pvItems, uxItems, pxHigherPriorityTaskWoken );
+
+    configASSERT( pxQueue );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    configASSERT( !( ( pvItems == NULL ) && ( uxItems != ( UBaseType_t ) 0U ) ) );
+
+    #if ( configUSE_QUEUE_SETS == 1 )
+    {
+        configASSERT( pxQueue->pxQueueSetContainer == NULL );
+    }
+    #endif
+
+    portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+    uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+    {
+        uxSent = prvCopyItemsToQueue( pxQueue, pvItems, uxItems );
+
+        if( uxSent > ( UBaseType_t ) 0U )
+        {
+            const int8_t cTxLock = pxQueue->cTxLock;
+
+            traceQUEUE_SEND_FROM_ISR( pxQueue );
+
+            /* The event list is not altered if the queue is locked.  This will
+             * be done when the queue is unlocked later. */
+            if( cTxLock == queueUNLOCKED )
+            {
+                if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToReceive ) ) == pdFALSE )
+                {
+                    if( ( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToReceive ) ) != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+                    {
+                        *pxHigherPriorityTaskWoken = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                prvIncrementQueueTxLock( pxQueue, cTxLock );
+            }
+        }
+        else
+        {
+            traceQUEUE_SEND_FROM_ISR_FAILED( pxQueue );
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    traceRETURN_uxQueueSendMultipleFromISR( uxSent );
+
+    return uxSent;
+}
+/*-----------------------------------------------------------*/
+
+UBaseType_t uxQueueReceiveMultipleFromISR( QueueHandle_t xQueue,
+                                           void * const pvItems,
+                                           const UBaseType_t uxItems,
+                                           BaseType_t * const pxHigherPriorityTaskWoken )
+{
+    UBaseType_t uxSavedInterruptStatus;
+    Queue_t * const pxQueue = xQueue;
+    UBaseType_t uxReceived;
+
+    traceENTER_uxQueueReceiveMultipleFromISR( xQueue, pvItems, uxItems, pxHigherPriorityTaskWoken );
+
+    configASSERT( pxQueue );
+    configASSERT( pxQueue->uxItemSize != ( UBaseType_t ) 0U );
+    configASSERT( !( ( pvItems == NULL ) && ( uxItems != ( UBaseType_t ) 0U ) ) );
+
+    portASSERT_IF_INTERRUPT_PRIORITY_INVALID();
+
+    uxSavedInterruptStatus = ( UBaseType_t ) taskENTER_CRITICAL_FROM_ISR();
+    {
+        uxReceived = prvCopyItemsFromQueue( pxQueue, pvItems, uxItems );
+
+        if( uxReceived > ( UBaseType_t ) 0U )
+        {
+            const int8_t cRxLock = pxQueue->cRxLock;
+
+            traceQUEUE_RECEIVE_FROM_ISR( pxQueue );
+
+            /* If the queue is locked the event list will not be modified.
+             * Instead update the lock count so the task that unlocks the queue
+             * will know that an ISR has removed data while the queue was
+             * locked. */
+            if( cRxLock == queueUNLOCKED )
+            {
+                if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
+                {
+                    if( ( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE ) && ( pxHigherPriorityTaskWoken != NULL ) )
+                    {
+                        *pxHigherPriorityTaskWoken = pdTRUE;
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                prvIncrementQueueRxLock( pxQueue, cRxLock );
+            }
+        }
+        else
+        {
+            traceQUEUE_RECEIVE_FROM_ISR_FAILED( pxQueue );
+        }
+    }
+    taskEXIT_CRITICAL_FROM_ISR( uxSavedInterruptStatus );
+
+    traceRETURN_uxQueueReceiveMultipleFromISR( uxReceived );
+
+    return uxReceived;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueueSemaphoreTake( QueueHandle_t xQueue,
+                                TickType_t xTicksToWait )
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+    Queue_t * const pxQueue = xQueue;
+
+    #if ( configUSE_MUTEXES == 1 )
+        BaseType_t xInheritanceOccurred = pdFALSE;
+    #endif
+
+    traceENTER_xQueueSemaphoreTake( xQueue, xTicksToWait );
+
+    /* Check the queue pointer is not NULL. */
+    configASSERT( ( pxQueue ) );
+
+    /* Check this really is a semaphore, in which case the item size will be
+     * 0. */
+    configASSERT( pxQueue->uxItemSize == 0 );
+
+    /* Cannot block if the scheduler is suspended. */
+    #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+    {
+        configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+    }
+    #endif
+
+    for( ; ; )
+    {
+        taskENTER_CRITICAL();
+        {
+            /* Semaphores are queues with an item size of 0, and where the
+             * number of messages in the queue is the semaphore's count value. */
+            const UBaseType_t uxSemaphoreCount = pxQueue->uxMessagesWaiting;
+
+            /* Is there data in the queue now?  To be running the calling task
+             * must be the highest priority task wanting to access the queue. */
+            if( uxSemaphoreCount > ( UBaseType_t ) 0 )
+            {
+                traceQUEUE_RECEIVE( pxQueue );
+
+                /* Semaphores are queues with a data size of zero and where the
+                 * messages waiting is the semaphore's count.  Reduce the count. */
+                pxQueue->uxMessagesWaiting = ( UBaseType_t ) ( uxSemaphoreCount - ( UBaseType_t ) 1 );
+
+                #if ( configUSE_MUTEXES == 1 )
+                {
+                    if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
+                    {
+                        /* Record the information required to implement
+                         * priority inheritance should it become necessary. */
+                        pxQueue->u.xSemaphore.xMutexHolder = pvTaskIncrementMutexHeldCount();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                #endif /* configUSE_MUTEXES */
+
+                /* Check to see if other tasks are blocked waiting to give the
+                 * semaphore, and if so, unblock the highest priority such task. */
+                if( listLIST_IS_EMPTY( &( pxQueue->xTasksWaitingToSend ) ) == pdFALSE )
+                {
+                    if( xTaskRemoveFromEventList( &( pxQueue->xTasksWaitingToSend ) ) != pdFALSE )
+                    {
+                        queueYIELD_IF_USING_PREEMPTION();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                taskEXIT_CRITICAL();
+
+                traceRETURN_xQueueSemaphoreTake( pdPASS );
+
+                return pdPASS;
+            }
+            else
+            {
+                if( xTicksToWait == ( TickType_t ) 0 )
+                {
+                    /* The semaphore count was 0 and no block time is specified
+                     * (or the block time has expired) so exit now. */
+                    taskEXIT_CRITICAL();
+
+                    traceQUEUE_RECEIVE_FAILED( pxQueue );
+                    traceRETURN_xQueueSemaphoreTake( errQUEUE_EMPTY );
+
+                    return errQUEUE_EMPTY;
+                }
+                else if( xEntryTimeSet == pdFALSE )
+                {
+                    /* The semaphore count was 0 and a block time was specified
+                     * so configure the timeout structure ready to block. */
+                    vTaskInternalSetTimeOutState( &xTimeOut );
+                    xEntryTimeSet = pdTRUE;
+                }
+                else
+                {
+                    /* Entry time was already set. */
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        /* Interrupts and other tasks can give to and take from the semaphore
+         * now the critical section has been exited. */
+
+        vTaskSuspendAll();
+        prvLockQueue( pxQueue );
+
+        /* Update the timeout state to see if it has expired yet. */
+        if( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE )
+        {
+            /* A block time is specified and not expired.  If the semaphore
+             * count is 0 then enter the Blocked state to wait for a semaphore to
+             * become available.  As semaphores are implemented with queues the
+             * queue being empty is equivalent to the semaphore count being 0. */
+            if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+            {
+                traceBLOCKING_ON_QUEUE_RECEIVE( pxQueue );
+
+                #if ( configUSE_MUTEXES == 1 )
+                {
+                    if( pxQueue->uxQueueType == queueQUEUE_IS_MUTEX )
+                    {
+                        taskENTER_CRITICAL();
+                        {
+                            xInheritanceOccurred = xTaskPriorityInherit( pxQueue->u.xSemaphore.xMutexHolder );
+                        }
+                        taskEXIT_CRITICAL();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                #endif /* if ( configUSE_MUTEXES == 1 ) */
+
+                vTaskPlaceOnEventList( &( pxQueue->xTasksWaitingToReceive ), xTicksToWait );
+                prvUnlockQueue( pxQueue );
+
+                if( xTaskResumeAll() == pdFALSE )
+                {
+                    taskYIELD_WITHIN_API();
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+            else
+            {
+                /* There was no timeout and the semaphore count was not 0, so
+                 * attempt to take the semaphore again. */
+                prvUnlockQueue( pxQueue );
+                ( void ) xTaskResumeAll();
+            }
+        }
+        else
+        {
+            /* Timed out. */
+            prvUnlockQueue( pxQueue );
+            ( void ) xTaskResumeAll();
+
+            /* If the semaphore count is 0 exit now as the timeout has
+             * expired.  Otherwise return to attempt to take the semaphore that is
+             * known to be available.  As semaphores are implemented by queues the
+             * queue being empty is equivalent to the semaphore count being 0. */
+            if( prvIsQueueEmpty( pxQueue ) != pdFALSE )
+            {
+                #if ( configUSE_MUTEXES == 1 )
+                {
+                    /* xInheritanceOccurred could only have be set if
+                     * pxQueue->uxQueueType == queueQUEUE_IS_MUTEX so no need to
+                     * test the mutex type again to check it is actually a mutex. */
+                    if( xInheritanceOccurred != pdFALSE )
+                    {
+                        taskENTER_CRITICAL();
+                        {
+                            UBaseType_t uxHighestWaitingPriority;
+
+                            /* This task blocking on the mutex caused another
+                             * task to inherit this task's priority.  Now this task
+                             * has timed out the priority should be disinherited
+                             * again, but only as low as the next highest priority
+                             * task that is waiting for the same mutex. */
+                            uxHighestWaitingPriority = prvGetDisinheritPriorityAfterTimeout( pxQueue );
+
+                            /* vTaskPriorityDisinheritAfterTimeout uses the uxHighestWaitingPriority
+                             * parameter to index pxReadyTasksLists when adding the task holding
+                             * mutex to the ready list for its new priority. Coverity thinks that
+                             * it can result in out-of-bounds access which is not true because
+                             * uxHighestWaitingPriority, as returned by prvGetDisinheritPriorityAfterTimeout,
+                             * is capped at ( configMAX_PRIORITIES - 1 ). */
+                            /* coverity[overrun] */
+                            vTaskPriorityDisinheritAfterTimeout( pxQueue->u.xSemaphore.xMutexHolder, uxHighestWaitingPriority );
+                        }
+                        taskEXIT_CRITICAL();
+                    }
+                }
+                #endif /* configUSE_MUTEXES */
+
+                traceQUEUE_RECEIVE_FAILED( pxQueue );
+                traceRETURN_xQueueSemaphoreTake( errQUEUE_EMPTY );
+
+                return errQUEUE_EMPTY;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+    }
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xQueuePeek( QueueHandle_t xQueue,
+                       void * const pvBuffer,
+                       TickType_t xTicksToWait )
+{
+    BaseType_t xEntryTimeSet = pdFALSE;
+    TimeOut_t xTimeOut;
+    int8_t * pcOriginalReadPosition;
+    Queue_t * const pxQueue = xQueue;
+
+    traceENTER_xQueuePeek( xQueue, pvBuffer, xTicksToWait );
+
+    /* Check the pointer is not NULL. */
+    configASSERT( ( pxQueue ) );
+
+    /* The buffer into which data is received can only be NULL if the data size
+     * is zero (so no data is copied into the buffer. */
+    configASSERT( !( ( ( pvBuffer ) == NULL ) && ( ( pxQueue )->uxItemSize != ( UBaseType_t ) 0U ) ) );
+
+    /* Cannot block if the scheduler is suspended. */
+    #if ( ( INCLUDE_xTaskGetSchedulerState == 1 ) || ( configUSE_TIMERS == 1 ) )
+    {
+        configASSERT( !( ( xTaskGetSchedulerState() == taskSCHEDULER_SUSPENDED ) && ( xTicksToWait != 0 ) ) );
+    }
+    #endif
+
+    for( ; ; )
+    {
+        taskENTER_CRITICAL();
+        {
+            const UBaseType_t uxMessagesWaiting = pxQueue->uxMessagesWaiting;
+
+            /* Is there data in the queue now?  To be running the calling task
+             * must be the highest priority task wanting to access the queue. */
+            if( uxMessagesWaiting > ( UBaseType_t ) 0 )
             {
                 /* Remember the read position so it can be reset after the data
                  * is read from the queue as this function is only peeking the
@@ -2410,7 +3092,7 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
     }
     else if( xPosition == queueSEND_TO_BACK )
     {
-        ( void ) memcpy( ( void * ) pxQueue->pcWriteTo, pvItemToQueue, ( size_t ) pxQueue->uxItemSize );
+        prvCopyItem( ( void * ) pxQueue->pcWriteTo, pvItemToQueue, pxQueue->uxItemSize );
         pxQueue->pcWriteTo += pxQueue->uxItemSize;
 
         if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail )
@@ -2424,7 +3106,7 @@ static BaseType_t prvCopyDataToQueue( Queue_t * const pxQueue,
     }
     else
     {
-        ( void ) memcpy( ( void * ) pxQueue->u.xQueue.pcReadFrom, pvItemToQueue, ( size_t ) pxQueue->uxItemSize );
+        prvCopyItem( ( void * ) pxQueue->u.xQueue.pcReadFrom, pvItemToQueue, pxQueue->uxItemSize );
         pxQueue->u.xQueue.pcReadFrom -= pxQueue->uxItemSize;
 
         if( pxQueue->u.xQueue.pcReadFrom < pxQueue->pcHead )
@@ -2479,8 +3161,135 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue,
             mtCOVERAGE_TEST_MARKER();
         }
 
-        ( void ) memcpy( ( void * ) pvBuffer, ( void * ) pxQueue->u.xQueue.pcReadFrom, ( size_t ) pxQueue->uxItemSize );
+        prvCopyItem( pvBuffer, ( void * ) pxQueue->u.xQueue.pcReadFrom, pxQueue->uxItemSize );
+    }
+}
+/*-----------------------------------------------------------*/
+
+static __inline__ void prvCopyItem( void * const pvDestination,
+                                    const void * const pvSource,
+                                    const UBaseType_t uxItemSize )
+{
+    uint8_t * const pucDestination = ( uint8_t * ) pvDestination;
+    const uint8_t * const pucSource = ( const uint8_t * ) pvSource;
+
+    switch( uxItemSize )
+    {
+        case 4:
+            pucDestination[ 3 ] = pucSource[ 3 ];
+            pucDestination[ 2 ] = pucSource[ 2 ];
+            /* fall through */
+
+        case 2:
+            pucDestination[ 1 ] = pucSource[ 1 ];
+            /* fall through */
+
+        case 1:
+            pucDestination[ 0 ] = pucSource[ 0 ];
+            break;
+
+        default:
+            ( void ) memcpy( pvDestination, pvSource, ( size_t ) uxItemSize );
+            break;
+    }
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvCopyItemsToQueue( Queue_t * const pxQueue,
+                                        const void * pvItems,
+                                        const UBaseType_t uxItems )
+{
+    UBaseType_t uxCount = pxQueue->uxLength - pxQueue->uxMessagesWaiting;
+    size_t xBytes, xFirstBytes;
+
+    if( uxItems < uxCount )
+    {
+        uxCount = uxItems;
+    }
+
+    if( uxCount > ( UBaseType_t ) 0U )
+    {
+        xBytes = ( size_t ) uxCount * ( size_t ) pxQueue->uxItemSize;
+        xFirstBytes = ( size_t ) ( pxQueue->u.xQueue.pcTail - pxQueue->pcWriteTo );
+
+        if( xFirstBytes >= xBytes )
+        {
+            ( void ) memcpy( ( void * ) pxQueue->pcWriteTo, pvItems, xBytes );
+            pxQueue->pcWriteTo += xBytes;
+        }
+        else
+        {
+            /* The items wrap around the end of the storage area. */
+            ( void ) memcpy( ( void * ) pxQueue->pcWriteTo, pvItems, xFirstBytes );
+            ( void ) memcpy( ( void * ) pxQueue->pcHead, ( const uint8_t * ) pvItems + xFirstBytes, xBytes - xFirstBytes );
+            pxQueue->pcWriteTo = pxQueue->pcHead + ( xBytes - xFirstBytes );
+        }
+
+        if( pxQueue->pcWriteTo >= pxQueue->u.xQueue.pcTail )
+        {
+            pxQueue->pcWriteTo = pxQueue->pcHead;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        pxQueue->uxMessagesWaiting = ( UBaseType_t ) ( pxQueue->uxMessagesWaiting + uxCount );
+    }
+
+    return uxCount;
+}
+/*-----------------------------------------------------------*/
+
+static UBaseType_t prvCopyItemsFromQueue( Queue_t * const pxQueue,
+                                          void * pvItems,
+                                          const UBaseType_t uxItems )
+{
+    UBaseType_t uxCount = pxQueue->uxMessagesWaiting;
+    size_t xBytes, xFirstBytes;
+    int8_t * pcReadFrom;
+
+    if( uxItems < uxCount )
+    {
+        uxCount = uxItems;
+    }
+
+    if( uxCount > ( UBaseType_t ) 0U )
+    {
+        /* pcReadFrom points to the last item read, so start at the next. */
+        pcReadFrom = pxQueue->u.xQueue.pcReadFrom + pxQueue->uxItemSize;
+
+        if( pcReadFrom >= pxQueue->u.xQueue.pcTail )
+        {
+            pcReadFrom = pxQueue->pcHead;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        xBytes = ( size_t ) uxCount * ( size_t ) pxQueue->uxItemSize;
+        xFirstBytes = ( size_t ) ( pxQueue->u.xQueue.pcTail - pcReadFrom );
+
+        if( xFirstBytes >= xBytes )
+        {
+            ( void ) memcpy( pvItems, ( void * ) pcReadFrom, xBytes );
+            pcReadFrom += xBytes;
+        }
+        else
+        {
+            /* The items wrap around the end of the storage area. */
+            ( void ) memcpy( pvItems, ( void * ) pcReadFrom, xFirstBytes );
+            ( void ) memcpy( ( uint8_t * ) pvItems + xFirstBytes, ( void * ) pxQueue->pcHead, xBytes - xFirstBytes );
+            pcReadFrom = pxQueue->pcHead + ( xBytes - xFirstBytes );
+        }
+
+        /* Leave pcReadFrom at the last item read. */
+        pxQueue->u.xQueue.pcReadFrom = pcReadFrom - pxQueue->uxItemSize;
+        pxQueue->uxMessagesWaiting = ( UBaseType_t ) ( pxQueue->uxMessagesWaiting - uxCount );
     }
+
+    return uxCount;
 }
 /*-----------------------------------------------------------*/
 
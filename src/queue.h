@@ -914,6 +914,267 @@ BaseType_t xQueueReceive( QueueHandle_t xQueue,
                           void * const pvBuffer,
                           TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
 
+/**
+ * queue. h
+ * @code{c}
+ * void * pvQueueAcquireSend(
+ *                            QueueHandle_t xQueue,
+ *                            TickType_t xTicksToWait
+ *                          );
+ * @endcode
+ *
+ * Acquire the next free item in the queue storage area, so the item can be
+ * written in place rather than copied in by xQueueSend().  The item is not
+ * visible to receivers until vQueueCommitSend() is called.  The calling task
+ * blocks while the queue is full, exactly as xQueueSend() does.
+ *
+ * Only one task may write to a queue with pvQueueAcquireSend(), and while it
+ * does the queue must not also be written with xQueueSend(),
+ * xQueueSendToFront() or xQueueOverwrite().  The queue can be read with
+ * xQueueReceive() or pvQueueAcquireReceive().
+ *
+ * @param xQueue The handle to the queue.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for space to become available on the queue.
+ *
+ * @return A pointer to uxItemSize bytes of the queue storage area, or NULL if
+ * the queue stayed full for xTicksToWait.
+ *
+ * Example usage:
+ * @code{c}
+ * struct ASample
+ * {
+ *  uint32_t ulTime;
+ *  int16_t sReading[ 14 ];
+ * };
+ *
+ * void vASensorTask( void *pvParameters )
+ * {
+ * struct ASample *pxSample;
+ *
+ *  for( ;; )
+ *  {
+ *      pxSample = pvQueueAcquireSend( xQueue, portMAX_DELAY );
+ *      pxSample->ulTime = micros();
+ *      vReadSensors( pxSample->sReading );
+ *      vQueueCommitSend( xQueue );
+ *  }
+ * }
+ * @endcode
+ * \defgroup pvQueueAcquireSend pvQueueAcquireSend
+ * \ingroup QueueManagement
+ */
+void * pvQueueAcquireSend( QueueHandle_t xQueue,
+                           TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * void vQueueCommitSend( QueueHandle_t xQueue );
+ * @endcode
+ *
+ * Add the item acquired with pvQueueAcquireSend() to the back of the queue,
+ * unblocking a task waiting to receive from the queue.
+ *
+ * @param xQueue The handle to the queue.
+ *
+ * \defgroup vQueueCommitSend vQueueCommitSend
+ * \ingroup QueueManagement
+ */
+void vQueueCommitSend( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * const void * pvQueueAcquireReceive(
+ *                                     QueueHandle_t xQueue,
+ *                                     TickType_t xTicksToWait
+ *                                   );
+ * @endcode
+ *
+ * Acquire the item at the front of the queue, so it can be read in place
+ * rather than copied out by xQueueReceive().  The item stays in the queue, so
+ * can't be overwritten, until vQueueReleaseReceive() is called.  The calling
+ * task blocks while the queue is empty, exactly as xQueueReceive() does.
+ *
+ * Only one task may read from a queue with pvQueueAcquireReceive(), and while
+ * it does the queue must not also be read with xQueueReceive(), or written
+ * with xQueueSendToFront() or xQueueOverwrite().  The queue can be written
+ * with xQueueSend() or pvQueueAcquireSend().
+ *
+ * @param xQueue The handle to the queue.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for an item to receive.
+ *
+ * @return A pointer to the item in the queue storage area, or NULL if the
+ * queue stayed empty for xTicksToWait.
+ *
+ * \defgroup pvQueueAcquireReceive pvQueueAcquireReceive
+ * \ingroup QueueManagement
+ */
+const void * pvQueueAcquireReceive( QueueHandle_t xQueue,
+                                    TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * void vQueueReleaseReceive( QueueHandle_t xQueue );
+ * @endcode
+ *
+ * Remove the item acquired with pvQueueAcquireReceive() from the queue,
+ * unblocking a task waiting to send to the queue.
+ *
+ * @param xQueue The handle to the queue.
+ *
+ * \defgroup vQueueReleaseReceive vQueueReleaseReceive
+ * \ingroup QueueManagement
+ */
+void vQueueReleaseReceive( QueueHandle_t xQueue ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * UBaseType_t uxQueueSendMultiple(
+ *                                  QueueHandle_t xQueue,
+ *                                  const void * pvItems,
+ *                                  UBaseType_t uxItems,
+ *                                  TickType_t xTicksToWait
+ *                                );
+ * @endcode
+ *
+ * Send up to uxItems items, held one after another at pvItems, to the back of
+ * the queue in one critical section, unblocking at most one task waiting to
+ * receive.  The calling task blocks while the queue is full, as xQueueSend()
+ * does, then sends as many items as there is space for.
+ *
+ * Items are copied by block, so sending a burst is much cheaper than calling
+ * xQueueSend() for each item.  The queue can't be a member of a queue set.
+ *
+ * @param xQueue The handle to the queue.
+ *
+ * @param pvItems A pointer to the items to be sent.
+ *
+ * @param uxItems The number of items at pvItems.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for space for at least one item.
+ *
+ * @return The number of items sent, which is 0 if the queue stayed full for
+ * xTicksToWait.
+ *
+ * Example usage:
+ * @code{c}
+ * uint8_t ucBurst[ 16 ];
+ * UBaseType_t uxSent = 0;
+ *
+ *  // Send the whole burst, waiting for space as the receiver empties the queue.
+ *  while( uxSent < sizeof( ucBurst ) )
+ *  {
+ *      uxSent += uxQueueSendMultiple( xQueue, &( ucBurst[ uxSent ] ), sizeof( ucBurst ) - uxSent, portMAX_DELAY );
+ *  }
+ * @endcode
+ * \defgroup uxQueueSendMultiple uxQueueSendMultiple
+ * \ingroup QueueManagement
+ */
+UBaseType_t uxQueueSendMultiple( QueueHandle_t xQueue,
+                                 const void * const pvItems,
+                                 const UBaseType_t uxItems,
+                                 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * UBaseType_t uxQueueReceiveMultiple(
+ *                                     QueueHandle_t xQueue,
+ *                                     void * pvItems,
+ *                                     UBaseType_t uxItems,
+ *                                     TickType_t xTicksToWait
+ *                                   );
+ * @endcode
+ *
+ * Receive up to uxItems items from the front of the queue into pvItems in one
+ * critical section, unblocking at most one task waiting to send.  The calling
+ * task blocks while the queue is empty, as xQueueReceive() does, then
+ * receives as many items as the queue holds.
+ *
+ * @param xQueue The handle to the queue.
+ *
+ * @param pvItems A pointer to a buffer of at least uxItems items.
+ *
+ * @param uxItems The most items to receive.
+ *
+ * @param xTicksToWait The maximum amount of time the task should block
+ * waiting for at least one item.
+ *
+ * @return The number of items received, which is 0 if the queue stayed empty
+ * for xTicksToWait.
+ *
+ * \defgroup uxQueueReceiveMultiple uxQueueReceiveMultiple
+ * \ingroup QueueManagement
+ */
+UBaseType_t uxQueueReceiveMultiple( QueueHandle_t xQueue,
+                                    void * const pvItems,
+                                    const UBaseType_t uxItems,
+                                    TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * UBaseType_t uxQueueSendMultipleFromISR(
+ *                                         QueueHandle_t xQueue,
+ *                                         const void * pvItems,
+ *                                         UBaseType_t uxItems,
+ *                                         BaseType_t * pxHigherPriorityTaskWoken
+ *                                       );
+ * @endcode
+ *
+ * A version of uxQueueSendMultiple() that can be called from an interrupt.
+ * It doesn't block, but sends as many items as there is space for.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if sending unblocked a task
+ * of higher priority than the interrupted task, in which case the interrupt
+ * should call portYIELD_FROM_ISR().
+ *
+ * @return The number of items sent.
+ *
+ * \defgroup uxQueueSendMultipleFromISR uxQueueSendMultipleFromISR
+ * \ingroup QueueManagement
+ */
+UBaseType_t uxQueueSendMultipleFromISR( QueueHandle_t xQueue,
+                                        const void * const pvItems,
+                                        const UBaseType_t uxItems,
+                                        BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * queue. h
+ * @code{c}
+ * UBaseType_t uxQueueReceiveMultipleFromISR(
+ *                                            QueueHandle_t xQueue,
+ *                                            void * pvItems,
+ *                                            UBaseType_t uxItems,
+ *                                            BaseType_t * pxHigherPriorityTaskWoken
+ *                                          );
+ * @endcode
+ *
+ * A version of uxQueueReceiveMultiple() that can be called from an interrupt.
+ * It doesn't block, but receives as many items as the queue holds.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if receiving unblocked a task
+ * of higher priority than the interrupted task, in which case the interrupt
+ * should call portYIELD_FROM_ISR().
+ *
+ * @return The number of items received.
+ *
+ * \defgroup uxQueueReceiveMultipleFromISR uxQueueReceiveMultipleFromISR
+ * \ingroup QueueManagement
+ */
+UBaseType_t uxQueueReceiveMultipleFromISR( QueueHandle_t xQueue,
+                                           void * const pvItems,
+                                           const UBaseType_t uxItems,
+                                           BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
 /**
  * queue. h
  * @code{c}
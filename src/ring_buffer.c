@@ -0,0 +1,244 @@
+/*
+ * FreeRTOS Kernel V11.1.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+
+/* Standard includes. */
+#include <stdlib.h>
+#include <string.h>
+
+/* Defining MPU_WRAPPERS_INCLUDED_FROM_API_FILE prevents task.h from redefining
+ * all the API functions to use the MPU wrappers. That should only be done when
+ * task.h is included from an application file. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* FreeRTOS includes. */
+#include "Arduino_FreeRTOS.h"
+#include "task.h"
+#include "ring_buffer.h"
+
+#undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+/* The reading task waits on its direct to task notification, so ring buffers
+ * need task notifications. This #if is closed at the very bottom of this file. */
+#if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configUSE_TASK_NOTIFICATIONS == 1 )
+
+/* Stops the compiler moving the buffer accesses past the index update that
+ * hands the bytes to the other side. */
+    #define ringMEMORY_BARRIER()    __asm__ __volatile__ ( "" ::: "memory" )
+
+    typedef struct RingBufferDef_t
+    {
+        uint8_t * pucBuffer;            /**< The storage area, allocated after the structure. */
+        volatile uint8_t ucHead;        /**< The index of the next byte to write. Only changed by the interrupt. */
+        volatile uint8_t ucTail;        /**< The index of the next byte to read. Only changed by the task. */
+        uint8_t ucMask;                 /**< The size of the storage area less one. */
+        uint8_t ucTriggerLevel;         /**< The number of bytes that unblocks the reading task. */
+        TaskHandle_t volatile xReader;  /**< The reading task, once it has called xRingBufferReceive(). */
+    } RingBuffer_t;
+
+/* The number of bytes in the buffer. */
+    #define ringBYTES_AVAILABLE( pxRing, ucHead, ucTail )    ( ( uint8_t ) ( ( uint8_t ) ( ( ucHead ) - ( ucTail ) ) & ( pxRing )->ucMask ) )
+
+/*-----------------------------------------------------------*/
+
+    RingBufferHandle_t xRingBufferCreate( size_t xBufferSizeBytes,
+                                          size_t xTriggerLevelBytes )
+    {
+        RingBuffer_t * pxRing;
+
+        configASSERT( ( xBufferSizeBytes >= 2U ) && ( xBufferSizeBytes <= 256U ) );
+        configASSERT( ( xBufferSizeBytes & ( xBufferSizeBytes - 1U ) ) == 0U );
+        configASSERT( ( xTriggerLevelBytes >= 1U ) && ( xTriggerLevelBytes < xBufferSizeBytes ) );
+
+        pxRing = ( RingBuffer_t * ) pvPortMalloc( sizeof( RingBuffer_t ) + xBufferSizeBytes );
+
+        if( pxRing != NULL )
+        {
+            pxRing->pucBuffer = ( uint8_t * ) ( pxRing + 1 );
+            pxRing->ucHead = 0U;
+            pxRing->ucTail = 0U;
+            pxRing->ucMask = ( uint8_t ) ( xBufferSizeBytes - 1U );
+            pxRing->ucTriggerLevel = ( uint8_t ) xTriggerLevelBytes;
+            pxRing->xReader = NULL;
+        }
+
+        return ( RingBufferHandle_t ) pxRing;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xRingBufferPutFromISR( RingBufferHandle_t xRingBuffer,
+                                      uint8_t ucByte,
+                                      BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        RingBuffer_t * const pxRing = ( RingBuffer_t * ) xRingBuffer;
+        const uint8_t ucHead = pxRing->ucHead;
+        const uint8_t ucNextHead = ( uint8_t ) ( ucHead + 1U ) & pxRing->ucMask;
+        const uint8_t ucTail = pxRing->ucTail;
+
+        if( ucNextHead == ucTail )
+        {
+            return pdFAIL;
+        }
+
+        pxRing->pucBuffer[ ucHead ] = ucByte;
+        ringMEMORY_BARRIER();
+        pxRing->ucHead = ucNextHead;
+
+        /* The task can't read while the interrupt runs, so the count only
+         * equals the trigger level as this byte reaches it. */
+        if( ( ringBYTES_AVAILABLE( pxRing, ucNextHead, ucTail ) == pxRing->ucTriggerLevel ) && ( pxRing->xReader != NULL ) )
+        {
+            vTaskNotifyGiveFromISR( pxRing->xReader, pxHigherPriorityTaskWoken );
+        }
+
+        return pdPASS;
+    }
+/*-----------------------------------------------------------*/
+
+    size_t xRingBufferSendFromISR( RingBufferHandle_t xRingBuffer,
+                                   const void * pvTxData,
+                                   size_t xDataLengthBytes,
+                                   BaseType_t * const pxHigherPriorityTaskWoken )
+    {
+        RingBuffer_t * const pxRing = ( RingBuffer_t * ) xRingBuffer;
+        uint8_t ucHead, ucAvailable;
+        size_t xFirstBytes;
+
+        configASSERT( pxRing );
+        configASSERT( !( ( pvTxData == NULL ) && ( xDataLengthBytes != 0U ) ) );
+
+        ucHead = pxRing->ucHead;
+        ucAvailable = ringBYTES_AVAILABLE( pxRing, ucHead, pxRing->ucTail );
+        xFirstBytes = ( size_t ) pxRing->ucMask + 1U - ucHead;
+
+        if( xDataLengthBytes > ( size_t ) ( pxRing->ucMask - ucAvailable ) )
+        {
+            xDataLengthBytes = ( size_t ) ( pxRing->ucMask - ucAvailable );
+        }
+
+        if( xDataLengthBytes > 0U )
+        {
+            /* Copy in at most two blocks, around the end of the storage area. */
+            if( xFirstBytes > xDataLengthBytes )
+            {
+                xFirstBytes = xDataLengthBytes;
+            }
+
+            ( void ) memcpy( &( pxRing->pucBuffer[ ucHead ] ), pvTxData, xFirstBytes );
+            ( void ) memcpy( pxRing->pucBuffer, ( const uint8_t * ) pvTxData + xFirstBytes, xDataLengthBytes - xFirstBytes );
+
+            ringMEMORY_BARRIER();
+            pxRing->ucHead = ( uint8_t ) ( ucHead + xDataLengthBytes ) & pxRing->ucMask;
+
+            if( ( ucAvailable < pxRing->ucTriggerLevel ) &&
+                ( ( ucAvailable + xDataLengthBytes ) >= pxRing->ucTriggerLevel ) &&
+                ( pxRing->xReader != NULL ) )
+            {
+                vTaskNotifyGiveFromISR( pxRing->xReader, pxHigherPriorityTaskWoken );
+            }
+        }
+
+        return xDataLengthBytes;
+    }
+/*-----------------------------------------------------------*/
+
+    size_t xRingBufferReceive( RingBufferHandle_t xRingBuffer,
+                               void * pvRxData,
+                               size_t xBufferLengthBytes,
+                               TickType_t xTicksToWait )
+    {
+        RingBuffer_t * const pxRing = ( RingBuffer_t * ) xRingBuffer;
+        const TaskHandle_t xCurrentTask = xTaskGetCurrentTaskHandle();
+        uint8_t ucTail;
+        size_t xCount, xFirstBytes;
+
+        configASSERT( pxRing );
+        configASSERT( !( ( pvRxData == NULL ) && ( xBufferLengthBytes != 0U ) ) );
+
+        if( pxRing->xReader != xCurrentTask )
+        {
+            /* The handle is two bytes, so it is changed with interrupts masked. */
+            taskENTER_CRITICAL();
+            {
+                pxRing->xReader = xCurrentTask;
+            }
+            taskEXIT_CRITICAL();
+        }
+
+        if( ( xTicksToWait != ( TickType_t ) 0 ) && ( xRingBufferBytesAvailable( xRingBuffer ) < pxRing->ucTriggerLevel ) )
+        {
+            /* Clear a notification given by an earlier trigger, then check again,
+             * so a trigger from now on is not missed. */
+            ( void ) ulTaskNotifyTake( pdTRUE, 0 );
+
+            if( xRingBufferBytesAvailable( xRingBuffer ) < pxRing->ucTriggerLevel )
+            {
+                ( void ) ulTaskNotifyTake( pdTRUE, xTicksToWait );
+            }
+        }
+
+        ucTail = pxRing->ucTail;
+        xCount = ringBYTES_AVAILABLE( pxRing, pxRing->ucHead, ucTail );
+
+        if( xCount > xBufferLengthBytes )
+        {
+            xCount = xBufferLengthBytes;
+        }
+
+        if( xCount > 0U )
+        {
+            /* Copy out in at most two blocks, around the end of the storage area. */
+            xFirstBytes = ( size_t ) pxRing->ucMask + 1U - ucTail;
+
+            if( xFirstBytes > xCount )
+            {
+                xFirstBytes = xCount;
+            }
+
+            ( void ) memcpy( pvRxData, &( pxRing->pucBuffer[ ucTail ] ), xFirstBytes );
+            ( void ) memcpy( ( uint8_t * ) pvRxData + xFirstBytes, pxRing->pucBuffer, xCount - xFirstBytes );
+
+            ringMEMORY_BARRIER();
+            pxRing->ucTail = ( uint8_t ) ( ucTail + xCount ) & pxRing->ucMask;
+        }
+
+        return xCount;
+    }
+/*-----------------------------------------------------------*/
+
+    size_t xRingBufferBytesAvailable( RingBufferHandle_t xRingBuffer )
+    {
+        RingBuffer_t * const pxRing = ( RingBuffer_t * ) xRingBuffer;
+
+        configASSERT( pxRing );
+
+        return ( size_t ) ringBYTES_AVAILABLE( pxRing, pxRing->ucHead, pxRing->ucTail );
+    }
+/*-----------------------------------------------------------*/
+
+#endif /* ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configUSE_TASK_NOTIFICATIONS == 1 ) */
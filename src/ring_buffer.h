@@ -0,0 +1,184 @@
+/*
+ * FreeRTOS Kernel V11.1.0
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * https://www.FreeRTOS.org
+ * https://github.com/FreeRTOS
+ *
+ */
+
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#ifndef INC_ARDUINO_FREERTOS_H
+    #error "include Arduino_FreeRTOS.h" must appear in source files before "include ring_buffer.h"
+#endif
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/**
+ * A ring buffer carries a stream of bytes from one interrupt to one task,
+ * for example the bytes received by a fast UART. The interrupt writes the
+ * buffer and the head index, and the task reads the buffer and the tail index,
+ * and each index is a single byte that the AVR loads and stores atomically. So
+ * neither side disables interrupts, and a byte is added in a few tens of
+ * cycles.
+ *
+ * The task blocks in xRingBufferReceive() on its direct to task notification
+ * (index 0), which the interrupt gives only when the number of bytes in the
+ * buffer reaches the trigger level.
+ *
+ * Only one interrupt may write to a ring buffer, and only one task may read
+ * from it.
+ */
+
+/**
+ * ring_buffer.h
+ *
+ * Type by which ring buffers are referenced.
+ */
+struct RingBufferDef_t;
+typedef struct RingBufferDef_t * RingBufferHandle_t;
+
+/**
+ * ring_buffer.h
+ * @code{c}
+ * RingBufferHandle_t xRingBufferCreate( size_t xBufferSizeBytes, size_t xTriggerLevelBytes );
+ * @endcode
+ *
+ * Create a ring buffer, allocated with pvPortMalloc().
+ *
+ * @param xBufferSizeBytes The size of the buffer, a power of two from 2 to 256.
+ * The buffer holds one byte less than this.
+ *
+ * @param xTriggerLevelBytes The number of bytes in the buffer that unblocks the
+ * task waiting in xRingBufferReceive(), from 1 to xBufferSizeBytes - 1.
+ *
+ * @return The handle of the ring buffer, or NULL if there wasn't enough heap.
+ *
+ * Example usage:
+ * @code{c}
+ * RingBufferHandle_t xRxRing;
+ *
+ * ISR( USART_RX_vect )
+ * {
+ *     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+ *
+ *     ( void ) xRingBufferPutFromISR( xRxRing, UDR0, &xHigherPriorityTaskWoken );
+ *
+ *     if( xHigherPriorityTaskWoken != pdFALSE )
+ *     {
+ *         portYIELD_FROM_ISR();
+ *     }
+ * }
+ *
+ * void vRxTask( void * pvParameters )
+ * {
+ *     uint8_t ucLine[ 32 ];
+ *     size_t xReceived;
+ *
+ *     for( ;; )
+ *     {
+ *         // Wait for 16 bytes, or whatever has arrived after 10 Ticks.
+ *         xReceived = xRingBufferReceive( xRxRing, ucLine, sizeof( ucLine ), 10 );
+ *     }
+ * }
+ *
+ * xRxRing = xRingBufferCreate( 64, 16 );
+ * @endcode
+ */
+RingBufferHandle_t xRingBufferCreate( size_t xBufferSizeBytes,
+                                      size_t xTriggerLevelBytes ) PRIVILEGED_FUNCTION;
+
+/**
+ * ring_buffer.h
+ * @code{c}
+ * BaseType_t xRingBufferPutFromISR( RingBufferHandle_t xRingBuffer, uint8_t ucByte, BaseType_t * pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Add one byte to the ring buffer, from the interrupt that writes it.
+ * *pxHigherPriorityTaskWoken is set to pdTRUE if the byte reached the trigger
+ * level and the reading task should run now, in which case the interrupt
+ * should call portYIELD_FROM_ISR().
+ *
+ * @return pdPASS, or pdFAIL if the buffer is full and the byte was dropped.
+ */
+BaseType_t xRingBufferPutFromISR( RingBufferHandle_t xRingBuffer,
+                                  uint8_t ucByte,
+                                  BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * ring_buffer.h
+ * @code{c}
+ * size_t xRingBufferSendFromISR( RingBufferHandle_t xRingBuffer, const void * pvTxData, size_t xDataLengthBytes, BaseType_t * pxHigherPriorityTaskWoken );
+ * @endcode
+ *
+ * Add as many of xDataLengthBytes bytes as there is space for, from the
+ * interrupt that writes the ring buffer.
+ *
+ * @return The number of bytes added.
+ */
+size_t xRingBufferSendFromISR( RingBufferHandle_t xRingBuffer,
+                               const void * pvTxData,
+                               size_t xDataLengthBytes,
+                               BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * ring_buffer.h
+ * @code{c}
+ * size_t xRingBufferReceive( RingBufferHandle_t xRingBuffer, void * pvRxData, size_t xBufferLengthBytes, TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Read up to xBufferLengthBytes bytes, from the task that reads the ring
+ * buffer. If there are fewer than the trigger level bytes in the buffer, the
+ * task blocks for up to xTicksToWait for the trigger level to be reached, then
+ * reads what there is.
+ *
+ * @return The number of bytes read, which can be 0.
+ */
+size_t xRingBufferReceive( RingBufferHandle_t xRingBuffer,
+                           void * pvRxData,
+                           size_t xBufferLengthBytes,
+                           TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * ring_buffer.h
+ * @code{c}
+ * size_t xRingBufferBytesAvailable( RingBufferHandle_t xRingBuffer );
+ * @endcode
+ *
+ * @return The number of bytes in the ring buffer.
+ */
+size_t xRingBufferBytesAvailable( RingBufferHandle_t xRingBuffer ) PRIVILEGED_FUNCTION;
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* RING_BUFFER_H */
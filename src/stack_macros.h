@@ -41,6 +41,11 @@
  * to which the bytes were set when the task was created have not been
  * overwritten.  Note this second test does not guarantee that an overflowed
  * stack will always be recognised.
+ *
+ * Setting configCHECK_FOR_STACK_OVERFLOW to 3 checks the current stack state,
+ * as 1 does, and the lowest stack byte only, rather than the last 16 bytes.
+ * Any overflow that has run through the end of the stack is caught, at a
+ * fraction of the cost of the second test.
  */
 
 /*-----------------------------------------------------------*/
@@ -61,7 +66,7 @@
         /* Is the currently saved stack pointer within the stack limit? */                      \
         if( pxCurrentTCB->pxTopOfStack <= pxCurrentTCB->pxStack + portSTACK_LIMIT_PADDING )     \
         {                                                                                       \
-            char * pcOverflowTaskName = pxCurrentTCB->pcTaskName;                               \
+            char * pcOverflowTaskName = ( char * ) pxCurrentTCB->pcTaskName;                    \
             vApplicationStackOverflowHook( ( TaskHandle_t ) pxCurrentTCB, pcOverflowTaskName ); \
         }                                                                                       \
     } while( 0 )
@@ -78,7 +83,7 @@
         /* Is the currently saved stack pointer within the stack limit? */                       \
         if( pxCurrentTCB->pxTopOfStack >= pxCurrentTCB->pxEndOfStack - portSTACK_LIMIT_PADDING ) \
         {                                                                                        \
-            char * pcOverflowTaskName = pxCurrentTCB->pcTaskName;                                \
+            char * pcOverflowTaskName = ( char * ) pxCurrentTCB->pcTaskName;                     \
             vApplicationStackOverflowHook( ( TaskHandle_t ) pxCurrentTCB, pcOverflowTaskName );  \
         }                                                                                        \
     } while( 0 )
@@ -86,7 +91,7 @@
 #endif /* configCHECK_FOR_STACK_OVERFLOW == 1 */
 /*-----------------------------------------------------------*/
 
-#if ( ( configCHECK_FOR_STACK_OVERFLOW > 1 ) && ( portSTACK_GROWTH < 0 ) )
+#if ( ( configCHECK_FOR_STACK_OVERFLOW == 2 ) && ( portSTACK_GROWTH < 0 ) )
 
     #define taskCHECK_FOR_STACK_OVERFLOW()                                                      \
     do {                                                                                        \
@@ -98,15 +103,15 @@
             ( pulStack[ 2 ] != ulCheckValue ) ||                                                \
             ( pulStack[ 3 ] != ulCheckValue ) )                                                 \
         {                                                                                       \
-            char * pcOverflowTaskName = pxCurrentTCB->pcTaskName;                               \
+            char * pcOverflowTaskName = ( char * ) pxCurrentTCB->pcTaskName;                    \
             vApplicationStackOverflowHook( ( TaskHandle_t ) pxCurrentTCB, pcOverflowTaskName ); \
         }                                                                                       \
     } while( 0 )
 
-#endif /* #if( configCHECK_FOR_STACK_OVERFLOW > 1 ) */
+#endif /* #if( configCHECK_FOR_STACK_OVERFLOW == 2 ) */
 /*-----------------------------------------------------------*/
 
-#if ( ( configCHECK_FOR_STACK_OVERFLOW > 1 ) && ( portSTACK_GROWTH > 0 ) )
+#if ( ( configCHECK_FOR_STACK_OVERFLOW == 2 ) && ( portSTACK_GROWTH > 0 ) )
 
     #define taskCHECK_FOR_STACK_OVERFLOW()                                                                                                \
     do {                                                                                                                                  \
@@ -123,12 +128,28 @@
         /* Has the extremity of the task stack ever been written over? */                                                                 \
         if( memcmp( ( void * ) pcEndOfStack, ( void * ) ucExpectedStackBytes, sizeof( ucExpectedStackBytes ) ) != 0 )                     \
         {                                                                                                                                 \
-            char * pcOverflowTaskName = pxCurrentTCB->pcTaskName;                                                                         \
+            char * pcOverflowTaskName = ( char * ) pxCurrentTCB->pcTaskName;                                                              \
             vApplicationStackOverflowHook( ( TaskHandle_t ) pxCurrentTCB, pcOverflowTaskName );                                           \
         }                                                                                                                                 \
     } while( 0 )
 
-#endif /* #if( configCHECK_FOR_STACK_OVERFLOW > 1 ) */
+#endif /* #if( configCHECK_FOR_STACK_OVERFLOW == 2 ) */
+/*-----------------------------------------------------------*/
+
+#if ( ( configCHECK_FOR_STACK_OVERFLOW == 3 ) && ( portSTACK_GROWTH < 0 ) )
+
+/* The stack pointer saved by the context switch, and a single guard byte. */
+    #define taskCHECK_FOR_STACK_OVERFLOW()                                                      \
+    do {                                                                                        \
+        if( ( pxCurrentTCB->pxTopOfStack <= pxCurrentTCB->pxStack + portSTACK_LIMIT_PADDING ) || \
+            ( *( ( uint8_t * ) pxCurrentTCB->pxStack ) != ( uint8_t ) tskSTACK_FILL_BYTE ) )     \
+        {                                                                                       \
+            char * pcOverflowTaskName = ( char * ) pxCurrentTCB->pcTaskName;                    \
+            vApplicationStackOverflowHook( ( TaskHandle_t ) pxCurrentTCB, pcOverflowTaskName ); \
+        }                                                                                       \
+    } while( 0 )
+
+#endif /* #if( configCHECK_FOR_STACK_OVERFLOW == 3 ) */
 /*-----------------------------------------------------------*/
 
 /* Remove stack overflow macro if not being used. */
@@ -327,6 +327,23 @@ static void prvInitialiseNewStreamBuffer( StreamBuffer_t * const pxStreamBuffer,
                                           StreamBufferCallbackFunction_t pxSendCompletedCallback,
                                           StreamBufferCallbackFunction_t pxReceiveCompletedCallback ) PRIVILEGED_FUNCTION;
 
+/*
+ * Block the calling task, for up to xTicksToWait ticks, until at least
+ * xRequiredSpace bytes are free, then return the number of bytes free.
+ */
+static size_t prvWaitForSpace( StreamBuffer_t * const pxStreamBuffer,
+                               size_t xRequiredSpace,
+                               TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/*
+ * Block the calling task, for up to xTicksToWait ticks, until more than
+ * xBytesToStoreMessageLength bytes are in the buffer, then return the number
+ * of bytes in the buffer.
+ */
+static size_t prvWaitForData( StreamBuffer_t * const pxStreamBuffer,
+                              size_t xBytesToStoreMessageLength,
+                              TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
 /*-----------------------------------------------------------*/
     #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
     StreamBufferHandle_t xStreamBufferGenericCreate( size_t xBufferSizeBytes,
@@ -806,15 +823,134 @@ size_t xStreamBufferBytesAvailable( StreamBufferHandle_t xStreamBuffer )
 }
 /*-----------------------------------------------------------*/
 
+static size_t prvWaitForSpace( StreamBuffer_t * const pxStreamBuffer,
+                               size_t xRequiredSpace,
+                               TickType_t xTicksToWait )
+{
+    size_t xSpace = 0;
+    TimeOut_t xTimeOut;
+
+    if( xTicksToWait != ( TickType_t ) 0 )
+    {
+        vTaskSetTimeOutState( &xTimeOut );
+
+        do
+        {
+            /* Wait until the required number of bytes are free in the message
+             * buffer. */
+            taskENTER_CRITICAL();
+            {
+                xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+
+                if( xSpace < xRequiredSpace )
+                {
+                    /* Clear notification state as going to wait for space. */
+                    ( void ) xTaskNotifyStateClearIndexed( NULL, pxStreamBuffer->uxNotificationIndex );
+
+                    /* Should only be one writer. */
+                    configASSERT( pxStreamBuffer->xTaskWaitingToSend == NULL );
+                    pxStreamBuffer->xTaskWaitingToSend = xTaskGetCurrentTaskHandle();
+                }
+                else
+                {
+                    taskEXIT_CRITICAL();
+                    break;
+                }
+            }
+            taskEXIT_CRITICAL();
+
+            traceBLOCKING_ON_STREAM_BUFFER_SEND( pxStreamBuffer );
+            ( void ) xTaskNotifyWaitIndexed( pxStreamBuffer->uxNotificationIndex, ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+            pxStreamBuffer->xTaskWaitingToSend = NULL;
+        } while( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    if( xSpace == ( size_t ) 0 )
+    {
+        xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    return xSpace;
+}
+/*-----------------------------------------------------------*/
+
+static size_t prvWaitForData( StreamBuffer_t * const pxStreamBuffer,
+                              size_t xBytesToStoreMessageLength,
+                              TickType_t xTicksToWait )
+{
+    size_t xBytesAvailable;
+
+    if( xTicksToWait != ( TickType_t ) 0 )
+    {
+        /* Checking if there is data and clearing the notification state must be
+         * performed atomically. */
+        taskENTER_CRITICAL();
+        {
+            xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+
+            /* If this function was invoked by a message buffer read then
+             * xBytesToStoreMessageLength holds the number of bytes used to hold
+             * the length of the next discrete message.  If this function was
+             * invoked by a stream buffer read then xBytesToStoreMessageLength will
+             * be 0. If this function was invoked by a stream batch buffer read
+             * then xBytesToStoreMessageLength will be xTriggerLevelBytes value
+             * for the buffer.*/
+            if( xBytesAvailable <= xBytesToStoreMessageLength )
+            {
+                /* Clear notification state as going to wait for data. */
+                ( void ) xTaskNotifyStateClearIndexed( NULL, pxStreamBuffer->uxNotificationIndex );
+
+                /* Should only be one reader. */
+                configASSERT( pxStreamBuffer->xTaskWaitingToReceive == NULL );
+                pxStreamBuffer->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( xBytesAvailable <= xBytesToStoreMessageLength )
+        {
+            /* Wait for data to be available. */
+            traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( pxStreamBuffer );
+            ( void ) xTaskNotifyWaitIndexed( pxStreamBuffer->uxNotificationIndex, ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
+            pxStreamBuffer->xTaskWaitingToReceive = NULL;
+
+            /* Recheck the data available after blocking. */
+            xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
+    }
+
+    return xBytesAvailable;
+}
+/*-----------------------------------------------------------*/
+
 size_t xStreamBufferSend( StreamBufferHandle_t xStreamBuffer,
                           const void * pvTxData,
                           size_t xDataLengthBytes,
                           TickType_t xTicksToWait )
 {
     StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
-    size_t xReturn, xSpace = 0;
+    size_t xReturn, xSpace;
     size_t xRequiredSpace = xDataLengthBytes;
-    TimeOut_t xTimeOut;
     size_t xMaxReportedSpace = 0;
 
     traceENTER_xStreamBufferSend( xStreamBuffer, pvTxData, xDataLengthBytes, xTicksToWait );
@@ -865,53 +1001,7 @@ size_t xStreamBufferSend( StreamBufferHandle_t xStreamBuffer,
         }
     }
 
-    if( xTicksToWait != ( TickType_t ) 0 )
-    {
-        vTaskSetTimeOutState( &xTimeOut );
-
-        do
-        {
-            /* Wait until the required number of bytes are free in the message
-             * buffer. */
-            taskENTER_CRITICAL();
-            {
-                xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
-
-                if( xSpace < xRequiredSpace )
-                {
-                    /* Clear notification state as going to wait for space. */
-                    ( void ) xTaskNotifyStateClearIndexed( NULL, pxStreamBuffer->uxNotificationIndex );
-
-                    /* Should only be one writer. */
-                    configASSERT( pxStreamBuffer->xTaskWaitingToSend == NULL );
-                    pxStreamBuffer->xTaskWaitingToSend = xTaskGetCurrentTaskHandle();
-                }
-                else
-                {
-                    taskEXIT_CRITICAL();
-                    break;
-                }
-            }
-            taskEXIT_CRITICAL();
-
-            traceBLOCKING_ON_STREAM_BUFFER_SEND( xStreamBuffer );
-            ( void ) xTaskNotifyWaitIndexed( pxStreamBuffer->uxNotificationIndex, ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
-            pxStreamBuffer->xTaskWaitingToSend = NULL;
-        } while( xTaskCheckForTimeOut( &xTimeOut, &xTicksToWait ) == pdFALSE );
-    }
-    else
-    {
-        mtCOVERAGE_TEST_MARKER();
-    }
-
-    if( xSpace == ( size_t ) 0 )
-    {
-        xSpace = xStreamBufferSpacesAvailable( pxStreamBuffer );
-    }
-    else
-    {
-        mtCOVERAGE_TEST_MARKER();
-    }
+    xSpace = prvWaitForSpace( pxStreamBuffer, xRequiredSpace, xTicksToWait );
 
     xReturn = prvWriteMessageToBuffer( pxStreamBuffer, pvTxData, xDataLengthBytes, xSpace, xRequiredSpace );
 
@@ -1084,56 +1174,7 @@ size_t xStreamBufferReceive( StreamBufferHandle_t xStreamBuffer,
         xBytesToStoreMessageLength = 0;
     }
 
-    if( xTicksToWait != ( TickType_t ) 0 )
-    {
-        /* Checking if there is data and clearing the notification state must be
-         * performed atomically. */
-        taskENTER_CRITICAL();
-        {
-            xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
-
-            /* If this function was invoked by a message buffer read then
-             * xBytesToStoreMessageLength holds the number of bytes used to hold
-             * the length of the next discrete message.  If this function was
-             * invoked by a stream buffer read then xBytesToStoreMessageLength will
-             * be 0. If this function was invoked by a stream batch buffer read
-             * then xBytesToStoreMessageLength will be xTriggerLevelBytes value
-             * for the buffer.*/
-            if( xBytesAvailable <= xBytesToStoreMessageLength )
-            {
-                /* Clear notification state as going to wait for data. */
-                ( void ) xTaskNotifyStateClearIndexed( NULL, pxStreamBuffer->uxNotificationIndex );
-
-                /* Should only be one reader. */
-                configASSERT( pxStreamBuffer->xTaskWaitingToReceive == NULL );
-                pxStreamBuffer->xTaskWaitingToReceive = xTaskGetCurrentTaskHandle();
-            }
-            else
-            {
-                mtCOVERAGE_TEST_MARKER();
-            }
-        }
-        taskEXIT_CRITICAL();
-
-        if( xBytesAvailable <= xBytesToStoreMessageLength )
-        {
-            /* Wait for data to be available. */
-            traceBLOCKING_ON_STREAM_BUFFER_RECEIVE( xStreamBuffer );
-            ( void ) xTaskNotifyWaitIndexed( pxStreamBuffer->uxNotificationIndex, ( uint32_t ) 0, ( uint32_t ) 0, NULL, xTicksToWait );
-            pxStreamBuffer->xTaskWaitingToReceive = NULL;
-
-            /* Recheck the data available after blocking. */
-            xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
-        }
-        else
-        {
-            mtCOVERAGE_TEST_MARKER();
-        }
-    }
-    else
-    {
-        xBytesAvailable = prvBytesInBuffer( pxStreamBuffer );
-    }
+    xBytesAvailable = prvWaitForData( pxStreamBuffer, xBytesToStoreMessageLength, xTicksToWait );
 
     /* Whether receiving a discrete message (where xBytesToStoreMessageLength
      * holds the number of bytes used to store the message length) or a stream of
@@ -1167,6 +1208,168 @@ size_t xStreamBufferReceive( StreamBufferHandle_t xStreamBuffer,
 }
 /*-----------------------------------------------------------*/
 
+size_t xStreamBufferAcquireSend( StreamBufferHandle_t xStreamBuffer,
+                                 void ** ppvData,
+                                 size_t xDataLengthBytes,
+                                 TickType_t xTicksToWait )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xSpace, xHead, xReturn;
+
+    traceENTER_xStreamBufferAcquireSend( xStreamBuffer, ppvData, xDataLengthBytes, xTicksToWait );
+
+    configASSERT( ppvData );
+    configASSERT( pxStreamBuffer );
+
+    /* A message must be written in one piece, so a window is only offered by a
+     * stream buffer. */
+    configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+    /* Wait for no more space than the buffer can ever report. */
+    xDataLengthBytes = configMIN( xDataLengthBytes, pxStreamBuffer->xLength - ( size_t ) 1 );
+
+    xSpace = prvWaitForSpace( pxStreamBuffer, xDataLengthBytes, xTicksToWait );
+
+    /* Only the writer moves xHead, so the window can't move under the caller.
+     * It stops at the end of the storage area, the rest of the free space
+     * being offered by the next call. */
+    xHead = pxStreamBuffer->xHead;
+    *ppvData = ( void * ) &( pxStreamBuffer->pucBuffer[ xHead ] );
+
+    xReturn = configMIN( xSpace, pxStreamBuffer->xLength - xHead );
+
+    traceRETURN_xStreamBufferAcquireSend( xReturn );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vStreamBufferCommitSend( StreamBufferHandle_t xStreamBuffer,
+                              size_t xDataLengthBytes )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xNextHead;
+
+    traceENTER_vStreamBufferCommitSend( xStreamBuffer, xDataLengthBytes );
+
+    configASSERT( pxStreamBuffer );
+    configASSERT( xDataLengthBytes <= xStreamBufferSpacesAvailable( pxStreamBuffer ) );
+
+    if( xDataLengthBytes > ( size_t ) 0 )
+    {
+        xNextHead = pxStreamBuffer->xHead + xDataLengthBytes;
+
+        if( xNextHead >= pxStreamBuffer->xLength )
+        {
+            xNextHead -= pxStreamBuffer->xLength;
+        }
+
+        pxStreamBuffer->xHead = xNextHead;
+
+        traceSTREAM_BUFFER_SEND( xStreamBuffer, xDataLengthBytes );
+
+        /* Was a task waiting for the data? */
+        if( prvBytesInBuffer( pxStreamBuffer ) >= pxStreamBuffer->xTriggerLevelBytes )
+        {
+            prvSEND_COMPLETED( pxStreamBuffer );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    traceRETURN_vStreamBufferCommitSend();
+}
+/*-----------------------------------------------------------*/
+
+size_t xStreamBufferAcquireReceive( StreamBufferHandle_t xStreamBuffer,
+                                    const void ** ppvData,
+                                    TickType_t xTicksToWait )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xReturn, xBytesAvailable, xBytesToWaitFor, xTail;
+
+    traceENTER_xStreamBufferAcquireReceive( xStreamBuffer, ppvData, xTicksToWait );
+
+    configASSERT( ppvData );
+    configASSERT( pxStreamBuffer );
+    configASSERT( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_MESSAGE_BUFFER ) == ( uint8_t ) 0 );
+
+    /* As xStreamBufferReceive(), a batching buffer blocks until it holds more
+     * than its trigger level. */
+    if( ( pxStreamBuffer->ucFlags & sbFLAGS_IS_BATCHING_BUFFER ) != ( uint8_t ) 0 )
+    {
+        xBytesToWaitFor = pxStreamBuffer->xTriggerLevelBytes;
+    }
+    else
+    {
+        xBytesToWaitFor = 0;
+    }
+
+    xBytesAvailable = prvWaitForData( pxStreamBuffer, xBytesToWaitFor, xTicksToWait );
+
+    if( xBytesAvailable > xBytesToWaitFor )
+    {
+        /* Only the reader moves xTail. The window stops at the end of the
+         * storage area, the rest of the data being offered by the next call. */
+        xTail = pxStreamBuffer->xTail;
+        *ppvData = ( const void * ) &( pxStreamBuffer->pucBuffer[ xTail ] );
+        xReturn = configMIN( xBytesAvailable, pxStreamBuffer->xLength - xTail );
+    }
+    else
+    {
+        traceSTREAM_BUFFER_RECEIVE_FAILED( xStreamBuffer );
+        *ppvData = NULL;
+        xReturn = 0;
+    }
+
+    traceRETURN_xStreamBufferAcquireReceive( xReturn );
+
+    return xReturn;
+}
+/*-----------------------------------------------------------*/
+
+void vStreamBufferReleaseReceive( StreamBufferHandle_t xStreamBuffer,
+                                  size_t xDataLengthBytes )
+{
+    StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
+    size_t xNextTail;
+
+    traceENTER_vStreamBufferReleaseReceive( xStreamBuffer, xDataLengthBytes );
+
+    configASSERT( pxStreamBuffer );
+    configASSERT( xDataLengthBytes <= prvBytesInBuffer( pxStreamBuffer ) );
+
+    if( xDataLengthBytes > ( size_t ) 0 )
+    {
+        xNextTail = pxStreamBuffer->xTail + xDataLengthBytes;
+
+        if( xNextTail >= pxStreamBuffer->xLength )
+        {
+            xNextTail -= pxStreamBuffer->xLength;
+        }
+
+        pxStreamBuffer->xTail = xNextTail;
+
+        traceSTREAM_BUFFER_RECEIVE( xStreamBuffer, xDataLengthBytes );
+
+        /* Was a task waiting for space in the buffer? */
+        prvRECEIVE_COMPLETED( xStreamBuffer );
+    }
+    else
+    {
+        mtCOVERAGE_TEST_MARKER();
+    }
+
+    traceRETURN_vStreamBufferReleaseReceive();
+}
+/*-----------------------------------------------------------*/
+
 size_t xStreamBufferNextMessageLengthBytes( StreamBufferHandle_t xStreamBuffer )
 {
     StreamBuffer_t * const pxStreamBuffer = xStreamBuffer;
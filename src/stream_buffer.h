@@ -879,6 +879,170 @@ size_t xStreamBufferReceiveFromISR( StreamBufferHandle_t xStreamBuffer,
                                     size_t xBufferLengthBytes,
                                     BaseType_t * const pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
 
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferAcquireSend( StreamBufferHandle_t xStreamBuffer,
+ *                                  void **ppvData,
+ *                                  size_t xDataLengthBytes,
+ *                                  TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Acquire the largest contiguous free region of a stream buffer, so bytes can
+ * be written in place rather than copied in by xStreamBufferSend().  The bytes
+ * are not visible to the reader until vStreamBufferCommitSend() is called.
+ *
+ * The calling task blocks until xDataLengthBytes bytes are free, exactly as
+ * xStreamBufferSend() does.  The region returned stops at the end of the
+ * buffer's storage area, so can be shorter than the free space, in which case
+ * the rest of the free space is returned by the next call after the commit.
+ *
+ * Stream buffers only, not message buffers.  Like the other writing functions,
+ * only one task may write to the stream buffer.
+ *
+ * configUSE_STREAM_BUFFERS must be set to 1 in for FreeRTOSConfig.h for
+ * xStreamBufferAcquireSend() to be available.
+ *
+ * @param xStreamBuffer The handle of the stream buffer to write to.
+ *
+ * @param ppvData Set to the start of the free region.
+ *
+ * @param xDataLengthBytes The number of free bytes to wait for.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for xDataLengthBytes bytes to become free.
+ *
+ * @return The length of the free region at *ppvData, which can be 0.
+ *
+ * Example use:
+ * @code{c}
+ * void vAFunction( StreamBufferHandle_t xStreamBuffer )
+ * {
+ * uint8_t *pucWindow;
+ * size_t xFree, xCount;
+ *
+ *  xFree = xStreamBufferAcquireSend( xStreamBuffer, ( void ** ) &pucWindow, 1, portMAX_DELAY );
+ *
+ *  // Read the serial port straight into the stream buffer.
+ *  for( xCount = 0; ( xCount < xFree ) && Serial.available(); xCount++ )
+ *  {
+ *      pucWindow[ xCount ] = Serial.read();
+ *  }
+ *
+ *  vStreamBufferCommitSend( xStreamBuffer, xCount );
+ * }
+ * @endcode
+ * \defgroup xStreamBufferAcquireSend xStreamBufferAcquireSend
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferAcquireSend( StreamBufferHandle_t xStreamBuffer,
+                                 void ** ppvData,
+                                 size_t xDataLengthBytes,
+                                 TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * void vStreamBufferCommitSend( StreamBufferHandle_t xStreamBuffer,
+ *                               size_t xDataLengthBytes );
+ * @endcode
+ *
+ * Add the first xDataLengthBytes bytes of the region acquired with
+ * xStreamBufferAcquireSend() to the stream buffer, unblocking the reader once
+ * the buffer holds its trigger level, as xStreamBufferSend() does.
+ *
+ * @param xStreamBuffer The handle of the stream buffer written to.
+ *
+ * @param xDataLengthBytes The number of bytes written, no more than the length
+ * returned by xStreamBufferAcquireSend().
+ *
+ * \defgroup vStreamBufferCommitSend vStreamBufferCommitSend
+ * \ingroup StreamBufferManagement
+ */
+void vStreamBufferCommitSend( StreamBufferHandle_t xStreamBuffer,
+                              size_t xDataLengthBytes ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * size_t xStreamBufferAcquireReceive( StreamBufferHandle_t xStreamBuffer,
+ *                                     const void **ppvData,
+ *                                     TickType_t xTicksToWait );
+ * @endcode
+ *
+ * Acquire the largest contiguous region of bytes in a stream buffer, so they
+ * can be read in place rather than copied out by xStreamBufferReceive().  The
+ * bytes stay in the buffer until vStreamBufferReleaseReceive() is called.
+ *
+ * The calling task blocks while the stream buffer is empty, or a batching
+ * buffer holds no more than its trigger level, exactly as
+ * xStreamBufferReceive() does.  The region returned stops at the end of the
+ * buffer's storage area, in which case the rest of the bytes are returned by
+ * the next call after the release.
+ *
+ * Stream buffers only, not message buffers.  Like the other reading functions,
+ * only one task may read from the stream buffer.
+ *
+ * configUSE_STREAM_BUFFERS must be set to 1 in for FreeRTOSConfig.h for
+ * xStreamBufferAcquireReceive() to be available.
+ *
+ * @param xStreamBuffer The handle of the stream buffer to read from.
+ *
+ * @param ppvData Set to the start of the region, or NULL if it is empty.
+ *
+ * @param xTicksToWait The maximum amount of time the task should remain in the
+ * Blocked state to wait for data to become available.
+ *
+ * @return The length of the region at *ppvData, or 0 if the call timed out.
+ *
+ * Example use:
+ * @code{c}
+ * void vAFunction( StreamBufferHandle_t xStreamBuffer )
+ * {
+ * const uint8_t *pucWindow;
+ * size_t xReceivedBytes;
+ *
+ *  xReceivedBytes = xStreamBufferAcquireReceive( xStreamBuffer, ( const void ** ) &pucWindow, portMAX_DELAY );
+ *
+ *  // Write the bytes straight from the stream buffer.
+ *  xReceivedBytes = Serial.write( pucWindow, xReceivedBytes );
+ *
+ *  vStreamBufferReleaseReceive( xStreamBuffer, xReceivedBytes );
+ * }
+ * @endcode
+ * \defgroup xStreamBufferAcquireReceive xStreamBufferAcquireReceive
+ * \ingroup StreamBufferManagement
+ */
+size_t xStreamBufferAcquireReceive( StreamBufferHandle_t xStreamBuffer,
+                                    const void ** ppvData,
+                                    TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * stream_buffer.h
+ *
+ * @code{c}
+ * void vStreamBufferReleaseReceive( StreamBufferHandle_t xStreamBuffer,
+ *                                   size_t xDataLengthBytes );
+ * @endcode
+ *
+ * Remove the first xDataLengthBytes bytes of the region acquired with
+ * xStreamBufferAcquireReceive() from the stream buffer, unblocking a writer
+ * waiting for space, as xStreamBufferReceive() does.
+ *
+ * @param xStreamBuffer The handle of the stream buffer read from.
+ *
+ * @param xDataLengthBytes The number of bytes consumed, no more than the
+ * length returned by xStreamBufferAcquireReceive().
+ *
+ * \defgroup vStreamBufferReleaseReceive vStreamBufferReleaseReceive
+ * \ingroup StreamBufferManagement
+ */
+void vStreamBufferReleaseReceive( StreamBufferHandle_t xStreamBuffer,
+                                  size_t xDataLengthBytes ) PRIVILEGED_FUNCTION;
+
 /**
  * stream_buffer.h
  *
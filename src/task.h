@@ -1761,6 +1761,9 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery ) PRIVILEGED_FUNCTION;
  * NULL is returned if no matching name is found.  INCLUDE_xTaskGetHandle
  * must be set to 1 in FreeRTOSConfig.h for pcTaskGetHandle() to be available.
  *
+ * With configTASK_NAMES_IN_PROGMEM set to 1, pcNameToQuery is in flash, as the
+ * task names are, for example xTaskGetHandle( PSTR( "Task_Name" ) ).
+ *
  * \defgroup pcTaskGetHandle pcTaskGetHandle
  * \ingroup TaskUtils
  */
@@ -156,6 +156,21 @@
     #define configIDLE_TASK_NAME    "IDLE"
 #endif
 
+#if ( configTASK_NAMES_IN_PROGMEM == 1 )
+
+/* With configTASK_NAMES_IN_PROGMEM, the TCB holds a pointer to the task name
+ * in flash, which is read with pgm_read_byte(), rather than a copy of it. */
+    static const char pcIdleTaskName[] PROGMEM = configIDLE_TASK_NAME;
+    static const char pcNoTaskName[] PROGMEM = "";
+#endif
+
+/* Deleted tasks are only recycled if they were allocated dynamically. */
+#if ( configTASK_RECYCLE_POOL_SIZE > 0 ) && ( INCLUDE_vTaskDelete == 1 ) && ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( portUSING_MPU_WRAPPERS == 0 )
+    #define tskRECYCLE_TASKS    1
+#else
+    #define tskRECYCLE_TASKS    0
+#endif
+
 #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
 
 /* If configUSE_PORT_OPTIMISED_TASK_SELECTION is 0 then task selection is
@@ -375,7 +390,11 @@ typedef struct TaskControlBlock_t
         volatile BaseType_t xTaskRunState;      /**< Used to identify the core the task is running on, if the task is running. Otherwise, identifies the task's state - not running or yielding. */
         UBaseType_t uxTaskAttributes;           /**< Task's attributes - currently used to identify the idle tasks. */
     #endif
-    char pcTaskName[ configMAX_TASK_NAME_LEN ]; /**< Descriptive name given to the task when created.  Facilitates debugging only. */
+    #if ( configTASK_NAMES_IN_PROGMEM == 1 )
+        const char * pcTaskName;                /**< Descriptive name given to the task when created, in flash.  Facilitates debugging only. */
+    #else
+        char pcTaskName[ configMAX_TASK_NAME_LEN ]; /**< Descriptive name given to the task when created.  Facilitates debugging only. */
+    #endif
 
     #if ( configUSE_TASK_PREEMPTION_DISABLE == 1 )
         BaseType_t xPreemptionDisable; /**< Used to prevent the task from being preempted. */
@@ -426,6 +445,10 @@ typedef struct TaskControlBlock_t
         uint8_t ucStaticallyAllocated; /**< Set to pdTRUE if the task is a statically allocated to ensure no attempt is made to free the memory. */
     #endif
 
+    #if ( tskRECYCLE_TASKS == 1 )
+        configSTACK_DEPTH_TYPE uxStackDepth; /**< The depth of the stack, to match a recycled TCB and stack to a new task. */
+    #endif
+
     #if ( INCLUDE_xTaskAbortDelay == 1 )
         uint8_t ucDelayAborted;
     #endif
@@ -466,6 +489,12 @@ PRIVILEGED_DATA static List_t xPendingReadyList;                         /**< Ta
 
 #endif
 
+#if ( tskRECYCLE_TASKS == 1 )
+
+    PRIVILEGED_DATA static TCB_t * pxRecycledTCBs[ configTASK_RECYCLE_POOL_SIZE ]; /**< The TCBs, with their stacks, of deleted tasks kept to be reused by xTaskCreate(). */
+
+#endif
+
 #if ( INCLUDE_vTaskSuspend == 1 )
 
     PRIVILEGED_DATA static List_t xSuspendedTaskList; /**< Tasks that are currently suspended. */
@@ -604,6 +633,23 @@ static portTASK_FUNCTION_PROTO( prvIdleTask, pvParameters ) PRIVILEGED_FUNCTION;
 
 #endif
 
+/*
+ * Keep the TCB and stack of a deleted task in pxRecycledTCBs[], rather than
+ * freeing them, and take them back out for a new task with the same stack
+ * depth, so that tasks that are created and deleted often do not fragment the
+ * heap. A new task of another stack depth frees the pool first, so that memory
+ * kept for reuse never makes its allocation fail.
+ */
+#if ( tskRECYCLE_TASKS == 1 )
+
+    static BaseType_t prvRecycleTCB( TCB_t * pxTCB ) PRIVILEGED_FUNCTION;
+
+    static TCB_t * prvTakeRecycledTCB( const configSTACK_DEPTH_TYPE uxStackDepth ) PRIVILEGED_FUNCTION;
+
+    static void prvFreeRecycledTCBs( void ) PRIVILEGED_FUNCTION;
+
+#endif
+
 /*
  * Used only by the idle task.  This checks to see if anything has been placed
  * in the list of tasks waiting to be deleted.  If so the task is cleaned up
@@ -1620,79 +1666,89 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
                                   UBaseType_t uxPriority,
                                   TaskHandle_t * const pxCreatedTask )
     {
-        TCB_t * pxNewTCB;
+        TCB_t * pxNewTCB = NULL;
 
-        /* If the stack grows down then allocate the stack then the TCB so the stack
-         * does not grow into the TCB.  Likewise if the stack grows up then allocate
-         * the TCB then the stack. */
-        #if ( portSTACK_GROWTH > 0 )
+        #if ( tskRECYCLE_TASKS == 1 )
         {
-            /* Allocate space for the TCB.  Where the memory comes from depends on
-             * the implementation of the port malloc function and whether or not static
-             * allocation is being used. */
-            /* MISRA Ref 11.5.1 [Malloc memory assignment] */
-            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
-            /* coverity[misra_c_2012_rule_11_5_violation] */
-            pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
+            /* Reuse the TCB and stack of a deleted task, if one is the right size. */
+            pxNewTCB = prvTakeRecycledTCB( uxStackDepth );
+        }
+        #endif
 
-            if( pxNewTCB != NULL )
+        if( pxNewTCB == NULL )
+        {
+            /* If the stack grows down then allocate the stack then the TCB so the stack
+             * does not grow into the TCB.  Likewise if the stack grows up then allocate
+             * the TCB then the stack. */
+            #if ( portSTACK_GROWTH > 0 )
             {
-                ( void ) memset( ( void * ) pxNewTCB, 0x00, sizeof( TCB_t ) );
-
-                /* Allocate space for the stack used by the task being created.
-                 * The base of the stack memory stored in the TCB so the task can
-                 * be deleted later if required. */
+                /* Allocate space for the TCB.  Where the memory comes from depends on
+                 * the implementation of the port malloc function and whether or not static
+                 * allocation is being used. */
                 /* MISRA Ref 11.5.1 [Malloc memory assignment] */
                 /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
                 /* coverity[misra_c_2012_rule_11_5_violation] */
-                pxNewTCB->pxStack = ( StackType_t * ) pvPortMallocStack( ( ( ( size_t ) uxStackDepth ) * sizeof( StackType_t ) ) );
+                pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
 
-                if( pxNewTCB->pxStack == NULL )
+                if( pxNewTCB != NULL )
                 {
-                    /* Could not allocate the stack.  Delete the allocated TCB. */
-                    vPortFree( pxNewTCB );
-                    pxNewTCB = NULL;
-                }
-            }
-        }
-        #else /* portSTACK_GROWTH */
-        {
-            StackType_t * pxStack;
+                    ( void ) memset( ( void * ) pxNewTCB, 0x00, sizeof( TCB_t ) );
 
-            /* Allocate space for the stack used by the task being created. */
-            /* MISRA Ref 11.5.1 [Malloc memory assignment] */
-            /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
-            /* coverity[misra_c_2012_rule_11_5_violation] */
-            pxStack = pvPortMallocStack( ( ( ( size_t ) uxStackDepth ) * sizeof( StackType_t ) ) );
+                    /* Allocate space for the stack used by the task being created.
+                     * The base of the stack memory stored in the TCB so the task can
+                     * be deleted later if required. */
+                    /* MISRA Ref 11.5.1 [Malloc memory assignment] */
+                    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                    /* coverity[misra_c_2012_rule_11_5_violation] */
+                    pxNewTCB->pxStack = ( StackType_t * ) pvPortMallocStack( ( ( ( size_t ) uxStackDepth ) * sizeof( StackType_t ) ) );
 
-            if( pxStack != NULL )
+                    if( pxNewTCB->pxStack == NULL )
+                    {
+                        /* Could not allocate the stack.  Delete the allocated TCB. */
+                        vPortFree( pxNewTCB );
+                        pxNewTCB = NULL;
+                    }
+                }
+            }
+            #else /* portSTACK_GROWTH */
             {
-                /* Allocate space for the TCB. */
+                StackType_t * pxStack;
+
+                /* Allocate space for the stack used by the task being created. */
                 /* MISRA Ref 11.5.1 [Malloc memory assignment] */
                 /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
                 /* coverity[misra_c_2012_rule_11_5_violation] */
-                pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
+                pxStack = pvPortMallocStack( ( ( ( size_t ) uxStackDepth ) * sizeof( StackType_t ) ) );
 
-                if( pxNewTCB != NULL )
+                if( pxStack != NULL )
                 {
-                    ( void ) memset( ( void * ) pxNewTCB, 0x00, sizeof( TCB_t ) );
+                    /* Allocate space for the TCB. */
+                    /* MISRA Ref 11.5.1 [Malloc memory assignment] */
+                    /* More details at: https://github.com/FreeRTOS/FreeRTOS-Kernel/blob/main/MISRA.md#rule-115 */
+                    /* coverity[misra_c_2012_rule_11_5_violation] */
+                    pxNewTCB = ( TCB_t * ) pvPortMalloc( sizeof( TCB_t ) );
 
-                    /* Store the stack location in the TCB. */
-                    pxNewTCB->pxStack = pxStack;
+                    if( pxNewTCB != NULL )
+                    {
+                        ( void ) memset( ( void * ) pxNewTCB, 0x00, sizeof( TCB_t ) );
+
+                        /* Store the stack location in the TCB. */
+                        pxNewTCB->pxStack = pxStack;
+                    }
+                    else
+                    {
+                        /* The stack cannot be used as the TCB was not created.  Free
+                         * it again. */
+                        vPortFreeStack( pxStack );
+                    }
                 }
                 else
                 {
-                    /* The stack cannot be used as the TCB was not created.  Free
-                     * it again. */
-                    vPortFreeStack( pxStack );
+                    pxNewTCB = NULL;
                 }
             }
-            else
-            {
-                pxNewTCB = NULL;
-            }
+            #endif /* portSTACK_GROWTH */
         }
-        #endif /* portSTACK_GROWTH */
 
         if( pxNewTCB != NULL )
         {
@@ -1704,6 +1760,12 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB ) PRIVILEGED_FUNCTION;
             }
             #endif /* tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE */
 
+            #if ( tskRECYCLE_TASKS == 1 )
+            {
+                pxNewTCB->uxStackDepth = uxStackDepth;
+            }
+            #endif
+
             prvInitialiseNewTask( pxTaskCode, pcName, uxStackDepth, pvParameters, uxPriority, pxCreatedTask, pxNewTCB, NULL );
         }
 
@@ -1856,6 +1918,12 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
     #endif /* portSTACK_GROWTH */
 
     /* Store the task name in the TCB. */
+    #if ( configTASK_NAMES_IN_PROGMEM == 1 )
+    {
+        pxNewTCB->pcTaskName = ( pcName != NULL ) ? pcName : pcNoTaskName;
+        ( void ) x;
+    }
+    #else
     if( pcName != NULL )
     {
         for( x = ( UBaseType_t ) 0; x < ( UBaseType_t ) configMAX_TASK_NAME_LEN; x++ )
@@ -1883,6 +1951,7 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
     {
         mtCOVERAGE_TEST_MARKER();
     }
+    #endif /* configTASK_NAMES_IN_PROGMEM */
 
     /* This is used as an array index so must ensure it's not too large. */
     configASSERT( uxPriority < configMAX_PRIORITIES );
@@ -3508,8 +3577,12 @@ static BaseType_t prvCreateIdleTasks( void )
 {
     BaseType_t xReturn = pdPASS;
     BaseType_t xCoreID;
-    char cIdleName[ configMAX_TASK_NAME_LEN ];
     TaskFunction_t pxIdleTaskFunction = NULL;
+
+    #if ( configTASK_NAMES_IN_PROGMEM == 1 )
+        const char * const cIdleName = pcIdleTaskName;
+    #else
+    char cIdleName[ configMAX_TASK_NAME_LEN ];
     BaseType_t xIdleTaskNameIndex;
 
     for( xIdleTaskNameIndex = ( BaseType_t ) 0; xIdleTaskNameIndex < ( BaseType_t ) configMAX_TASK_NAME_LEN; xIdleTaskNameIndex++ )
@@ -3528,6 +3601,7 @@ static BaseType_t prvCreateIdleTasks( void )
             mtCOVERAGE_TEST_MARKER();
         }
     }
+    #endif /* configTASK_NAMES_IN_PROGMEM */
 
     /* Add each idle task at the lowest priority. */
     for( xCoreID = ( BaseType_t ) 0; xCoreID < ( BaseType_t ) configNUMBER_OF_CORES; xCoreID++ )
@@ -4178,7 +4252,8 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
 
     traceRETURN_pcTaskGetName( &( pxTCB->pcTaskName[ 0 ] ) );
 
-    return &( pxTCB->pcTaskName[ 0 ] );
+    /* With configTASK_NAMES_IN_PROGMEM, this is a pointer to flash. */
+    return ( char * ) &( pxTCB->pcTaskName[ 0 ] );
 }
 /*-----------------------------------------------------------*/
 
@@ -4211,9 +4286,17 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
 
                 for( x = ( UBaseType_t ) 0; x < ( UBaseType_t ) configMAX_TASK_NAME_LEN; x++ )
                 {
-                    cNextChar = pxTCB->pcTaskName[ x ];
+                    /* With configTASK_NAMES_IN_PROGMEM, the name queried is in
+                     * flash too, as the task names are. */
+                    #if ( configTASK_NAMES_IN_PROGMEM == 1 )
+                        cNextChar = ( char ) pgm_read_byte( &( pxTCB->pcTaskName[ x ] ) );
+
+                        if( cNextChar != ( char ) pgm_read_byte( &( pcNameToQuery[ x ] ) ) )
+                    #else
+                        cNextChar = pxTCB->pcTaskName[ x ];
 
-                    if( cNextChar != pcNameToQuery[ x ] )
+                        if( cNextChar != pcNameToQuery[ x ] )
+                    #endif
                     {
                         /* Characters didn't match. */
                         xBreakLoop = pdTRUE;
@@ -4264,7 +4347,11 @@ char * pcTaskGetName( TaskHandle_t xTaskToQuery )
         traceENTER_xTaskGetHandle( pcNameToQuery );
 
         /* Task names will be truncated to configMAX_TASK_NAME_LEN - 1 bytes. */
-        configASSERT( strlen( pcNameToQuery ) < configMAX_TASK_NAME_LEN );
+        #if ( configTASK_NAMES_IN_PROGMEM == 1 )
+            configASSERT( strlen_P( pcNameToQuery ) < configMAX_TASK_NAME_LEN );
+        #else
+            configASSERT( strlen( pcNameToQuery ) < configMAX_TASK_NAME_LEN );
+        #endif
 
         vTaskSuspendAll();
         {
@@ -6414,9 +6501,14 @@ static void prvCheckTasksWaitingTermination( void )
         #if ( ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) && ( configSUPPORT_STATIC_ALLOCATION == 0 ) && ( portUSING_MPU_WRAPPERS == 0 ) )
         {
             /* The task can only have been allocated dynamically - free both
-             * the stack and TCB. */
-            vPortFreeStack( pxTCB->pxStack );
-            vPortFree( pxTCB );
+             * the stack and TCB, unless they are kept to be recycled. */
+            #if ( tskRECYCLE_TASKS == 1 )
+                if( prvRecycleTCB( pxTCB ) == pdFALSE )
+            #endif
+            {
+                vPortFreeStack( pxTCB->pxStack );
+                vPortFree( pxTCB );
+            }
         }
         #elif ( tskSTATIC_AND_DYNAMIC_ALLOCATION_POSSIBLE != 0 )
         {
@@ -6426,9 +6518,14 @@ static void prvCheckTasksWaitingTermination( void )
             if( pxTCB->ucStaticallyAllocated == tskDYNAMICALLY_ALLOCATED_STACK_AND_TCB )
             {
                 /* Both the stack and TCB were allocated dynamically, so both
-                 * must be freed. */
-                vPortFreeStack( pxTCB->pxStack );
-                vPortFree( pxTCB );
+                 * must be freed, unless they are kept to be recycled. */
+                #if ( tskRECYCLE_TASKS == 1 )
+                    if( prvRecycleTCB( pxTCB ) == pdFALSE )
+                #endif
+                {
+                    vPortFreeStack( pxTCB->pxStack );
+                    vPortFree( pxTCB );
+                }
             }
             else if( pxTCB->ucStaticallyAllocated == tskSTATICALLY_ALLOCATED_STACK_ONLY )
             {
@@ -6450,6 +6547,100 @@ static void prvCheckTasksWaitingTermination( void )
 #endif /* INCLUDE_vTaskDelete */
 /*-----------------------------------------------------------*/
 
+#if ( tskRECYCLE_TASKS == 1 )
+
+    static BaseType_t prvRecycleTCB( TCB_t * pxTCB )
+    {
+        BaseType_t xRecycled = pdFALSE;
+        UBaseType_t uxIndex;
+
+        /* Tasks are deleted both by the idle task and by vTaskDelete(), so
+         * the pool is only changed in a critical section. */
+        taskENTER_CRITICAL();
+        {
+            for( uxIndex = 0U; uxIndex < ( UBaseType_t ) configTASK_RECYCLE_POOL_SIZE; uxIndex++ )
+            {
+                if( pxRecycledTCBs[ uxIndex ] == NULL )
+                {
+                    pxRecycledTCBs[ uxIndex ] = pxTCB;
+                    xRecycled = pdTRUE;
+                    break;
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        return xRecycled;
+    }
+/*-----------------------------------------------------------*/
+
+    static TCB_t * prvTakeRecycledTCB( const configSTACK_DEPTH_TYPE uxStackDepth )
+    {
+        TCB_t * pxTCB = NULL;
+        StackType_t * pxStack;
+        UBaseType_t uxIndex;
+
+        taskENTER_CRITICAL();
+        {
+            for( uxIndex = 0U; uxIndex < ( UBaseType_t ) configTASK_RECYCLE_POOL_SIZE; uxIndex++ )
+            {
+                if( ( pxRecycledTCBs[ uxIndex ] != NULL ) && ( pxRecycledTCBs[ uxIndex ]->uxStackDepth == uxStackDepth ) )
+                {
+                    pxTCB = pxRecycledTCBs[ uxIndex ];
+                    pxRecycledTCBs[ uxIndex ] = NULL;
+                    break;
+                }
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( pxTCB != NULL )
+        {
+            /* Clear the TCB as if it had just been allocated, keeping its stack. */
+            pxStack = pxTCB->pxStack;
+            ( void ) memset( ( void * ) pxTCB, 0x00, sizeof( TCB_t ) );
+            pxTCB->pxStack = pxStack;
+        }
+        else
+        {
+            /* None is the right size, so the new task will be allocated. Return
+             * the pool to the heap first, as the allocation may need it. */
+            prvFreeRecycledTCBs();
+        }
+
+        return pxTCB;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvFreeRecycledTCBs( void )
+    {
+        TCB_t * pxTCB;
+        UBaseType_t uxIndex;
+
+        for( uxIndex = 0U; uxIndex < ( UBaseType_t ) configTASK_RECYCLE_POOL_SIZE; uxIndex++ )
+        {
+            taskENTER_CRITICAL();
+            {
+                pxTCB = pxRecycledTCBs[ uxIndex ];
+                pxRecycledTCBs[ uxIndex ] = NULL;
+            }
+            taskEXIT_CRITICAL();
+
+            if( pxTCB != NULL )
+            {
+                vPortFreeStack( pxTCB->pxStack );
+                vPortFree( pxTCB );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+    }
+
+#endif /* tskRECYCLE_TASKS */
+/*-----------------------------------------------------------*/
+
 static void prvResetNextTaskUnblockTime( void )
 {
     if( listLIST_IS_EMPTY( pxDelayedTaskList ) != pdFALSE )
@@ -7186,7 +7377,15 @@ static void prvResetNextTaskUnblockTime( void )
         size_t x;
 
         /* Start by copying the entire string. */
-        ( void ) strcpy( pcBuffer, pcTaskName );
+        #if ( configTASK_NAMES_IN_PROGMEM == 1 )
+        {
+            /* Names in flash aren't truncated when the task is created. */
+            ( void ) strncpy_P( pcBuffer, pcTaskName, configMAX_TASK_NAME_LEN - 1U );
+            pcBuffer[ configMAX_TASK_NAME_LEN - 1U ] = ( char ) 0x00;
+        }
+        #else
+            ( void ) strcpy( pcBuffer, pcTaskName );
+        #endif
 
         /* Pad the end of the string with spaces to ensure columns line up when
          * printed out. */
@@ -65,6 +65,14 @@
         #define configTIMER_SERVICE_TASK_NAME    "Tmr Svc"
     #endif
 
+/* With configTASK_NAMES_IN_PROGMEM, the name of the timer service task is in flash. */
+    #if ( configTASK_NAMES_IN_PROGMEM == 1 )
+        static const char pcTimerServiceTaskName[] PROGMEM = configTIMER_SERVICE_TASK_NAME;
+        #define tmrTIMER_SERVICE_TASK_NAME    pcTimerServiceTaskName
+    #else
+        #define tmrTIMER_SERVICE_TASK_NAME    configTIMER_SERVICE_TASK_NAME
+    #endif
+
     #if ( ( configNUMBER_OF_CORES > 1 ) && ( configUSE_CORE_AFFINITY == 1 ) )
 
 /* The core affinity assigned to the timer service task on SMP systems.
@@ -254,7 +262,7 @@
 
                     vApplicationGetTimerTaskMemory( &pxTimerTaskTCBBuffer, &pxTimerTaskStackBuffer, &uxTimerTaskStackSize );
                     xTimerTaskHandle = xTaskCreateStaticAffinitySet( prvTimerTask,
-                                                                     configTIMER_SERVICE_TASK_NAME,
+                                                                     tmrTIMER_SERVICE_TASK_NAME,
                                                                      uxTimerTaskStackSize,
                                                                      NULL,
                                                                      ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) | portPRIVILEGE_BIT,
@@ -270,7 +278,7 @@
                 #else /* if ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
                 {
                     xReturn = xTaskCreateAffinitySet( prvTimerTask,
-                                                      configTIMER_SERVICE_TASK_NAME,
+                                                      tmrTIMER_SERVICE_TASK_NAME,
                                                       configTIMER_TASK_STACK_DEPTH,
                                                       NULL,
                                                       ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) | portPRIVILEGE_BIT,
@@ -289,7 +297,7 @@
 
                     vApplicationGetTimerTaskMemory( &pxTimerTaskTCBBuffer, &pxTimerTaskStackBuffer, &uxTimerTaskStackSize );
                     xTimerTaskHandle = xTaskCreateStatic( prvTimerTask,
-                                                          configTIMER_SERVICE_TASK_NAME,
+                                                          tmrTIMER_SERVICE_TASK_NAME,
                                                           uxTimerTaskStackSize,
                                                           NULL,
                                                           ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) | portPRIVILEGE_BIT,
@@ -304,7 +312,7 @@
                 #else /* if ( configSUPPORT_STATIC_ALLOCATION == 1 ) */
                 {
                     xReturn = xTaskCreate( prvTimerTask,
-                                           configTIMER_SERVICE_TASK_NAME,
+                                           tmrTIMER_SERVICE_TASK_NAME,
                                            configTIMER_TASK_STACK_DEPTH,
                                            NULL,
                                            ( ( UBaseType_t ) configTIMER_TASK_PRIORITY ) | portPRIVILEGE_BIT,
@@ -48,7 +48,12 @@ void initVariant(void)
 {
     // As the Task stacks are on heap before Task allocated heap variables,
     // the library default __malloc_heap_end = 0 doesn't work.
+#if ( configISR_STACK_SIZE > 0 )
+    // Leave the interrupt stack free, at the top of the main() stack.
+    __malloc_heap_end = (char *)(RAMEND - configMAX( __malloc_margin, (size_t)configISR_STACK_SIZE ));
+#else
     __malloc_heap_end = (char *)(RAMEND - __malloc_margin);
+#endif
 
 #if defined(USBCON)
     USBDevice.attach();